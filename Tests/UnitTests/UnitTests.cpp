@@ -4,6 +4,9 @@
 
 #include <iomanip>
 #include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <vector>
 #include "pch.h"
 #include "CppUnitTest.h"
 
@@ -11,6 +14,12 @@
 #include "largeInt.hpp"
 #include "utils.hpp"
 #include "bitwise-functions.hpp"
+#include "montgomery.hpp"
+#include "exponentiation.hpp"
+#include "parallel-executor.hpp"
+#include "scratch-arena.hpp"
+#include "expression-templates.hpp"
+#include "text-codecs.hpp"
 
 #else
 /*
@@ -21,6 +30,12 @@ in the project settings right now so this is a quick fix.
 #include "../../largeInt.hpp"
 #include "../../utils.hpp"
 #include "../../bitwise-functions.hpp"
+#include "../../montgomery.hpp"
+#include "../../exponentiation.hpp"
+#include "../../parallel-executor.hpp"
+#include "../../scratch-arena.hpp"
+#include "../../expression-templates.hpp"
+#include "../../text-codecs.hpp"
 
 #endif
 
@@ -150,6 +165,325 @@ namespace LARGE_INT {
 			Assert::AreEqual(sizeof(uint256_t), sizeof(uint64_t) * 4);
 		}
 	};
+
+	TEST_CLASS(SHIFTS_AND_LOGIC) {
+	private:
+		static uint_array<16> pattern() {
+			uint_array<16> value;
+			for (uint8_t i = 0; i < 16; ++i) {
+				value[i] = 0x9E3779B97F4A7C15ULL * (i + 1) ^ (0xF0F0F0F0F0F0F0F0ULL >> i);
+			}
+			return value;
+		}
+
+	public:
+		TEST_METHOD(SHIFT_256) {
+			const uint256_t a = { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x8000000000000001, 0xDEADBEEFCAFEBABE };
+
+			Assert::AreEqual(uint256_t{ 0x02468ACF13579BDF, 0xFDB97530ECA86421, 0x0000000000000003, 0xBD5B7DDF95FD757C }, a << 1);
+			Assert::AreEqual(uint256_t{ 0x0091A2B3C4D5E6F7, 0xFF6E5D4C3B2A1908, 0x4000000000000000, 0xEF56DF77E57F5D5F }, a >> 1);
+			Assert::AreEqual(uint256_t{ 0xF6E5D4C3B2A19084, 0x000000000000000E, 0xF56DF77E57F5D5F0, 0x0 }, a << 67);
+			Assert::AreEqual(uint256_t{ 0x0, 0x002468ACF13579BD, 0xFFDB97530ECA8642, 0x1000000000000000 }, a >> 67);
+			Assert::AreEqual(uint256_t{ 0xADBEEFCAFEBABE00, 0x0, 0x0, 0x0 }, a << 200);
+			Assert::AreEqual(uint256_t{ 0x0, 0x0, 0x0, 0x000123456789ABCD }, a >> 200);
+			Assert::AreEqual(uint256_t(0), a << 256);
+			Assert::AreEqual(uint256_t(0), a >> 300);
+		}
+
+		TEST_METHOD(SHIFT_ASSIGN_256) {
+			uint256_t a = { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x8000000000000001, 0xDEADBEEFCAFEBABE };
+			const uint256_t b = a;
+			a <<= 67;
+			Assert::AreEqual(b << 67, a);
+			a = b;
+			a >>= 67;
+			Assert::AreEqual(b >> 67, a);
+		}
+
+		TEST_METHOD(ROTATE_256) {
+			const uint256_t a = { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x8000000000000001, 0xDEADBEEFCAFEBABE };
+
+			Assert::AreEqual(uint256_t{ 0x6543210800000000, 0x0000001DEADBEEFC, 0xAFEBABE012345678, 0x9ABCDEFFEDCBA987 }, a.rotateLeft(100));
+			Assert::AreEqual(a.rotateLeft(100), a.rotateRight(156));
+			Assert::AreEqual(a, a.rotateLeft(256));
+			Assert::AreEqual(a, a.rotateLeft(37).rotateRight(37));
+		}
+
+		// uint_array<16> runs the vector path - checked against single-bit steps, which only use the scalar tail
+		TEST_METHOD(SHIFT_1024_MATCHES_SINGLE_STEPS) {
+			const uint_array<16> a = pattern();
+			for (const uint16_t places : { 1, 7, 63, 64, 65, 130, 511, 777, 1023 }) {
+				uint_array<16> left = a, right = a;
+				for (uint16_t i = 0; i < places; ++i) {
+					left = left << 1;
+					right = right >> 1;
+				}
+				Assert::AreEqual(left, a << places);
+				Assert::AreEqual(right, a >> places);
+				uint_array<16> inPlace = a;
+				inPlace <<= places;
+				Assert::AreEqual(left, inPlace);
+				inPlace = a;
+				inPlace >>= places;
+				Assert::AreEqual(right, inPlace);
+				Assert::AreEqual(a, a.rotateLeft(places).rotateRight(places));
+				Assert::AreEqual((a << places) | (a >> (1024 - places)), a.rotateLeft(places));
+			}
+		}
+
+		TEST_METHOD(BITWISE_MIXED_WIDTHS) {
+			const uint256_t a = { 0xFF00FF00FF00FF00, 0x0, 0xFFFFFFFFFFFFFFFF, 0x0123456789ABCDEF };
+			const uint512_t b = { 0x1, 0x2, 0x3, 0x4, 0x0F0F0F0F0F0F0F0F, 0xFFFFFFFFFFFFFFFF, 0x0, 0xFFFF };
+
+			Assert::AreEqual(uint512_t{ 0x0, 0x0, 0x0, 0x0, 0x0F000F000F000F00, 0x0, 0x0, 0xCDEF }, a & b);
+			Assert::AreEqual(uint512_t{ 0x1, 0x2, 0x3, 0x4, 0xFF0FFF0FFF0FFF0F, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0x0123456789ABFFFF }, a | b);
+			Assert::AreEqual(uint512_t{ 0x1, 0x2, 0x3, 0x4, 0xF00FF00FF00FF00F, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0x0123456789AB3210 }, b ^ a);
+			Assert::AreEqual(uint256_t{ 0x00FF00FF00FF00FF, 0xFFFFFFFFFFFFFFFF, 0x0, 0xFEDCBA9876543210 }, ~a);
+
+			uint256_t c = a;
+			c &= b;
+			Assert::AreEqual(uint256_t{ 0x0F000F000F000F00, 0x0, 0x0, 0xCDEF }, c);
+			c = a;
+			c ^= a;
+			Assert::AreEqual(uint256_t(0), c);
+			c |= uint128_t{ 0x1, 0x2 };
+			Assert::AreEqual(uint256_t{ 0x0, 0x0, 0x1, 0x2 }, c);
+		}
+	};
+
+	TEST_CLASS(BIT_COUNTS) {
+	public:
+		TEST_METHOD(ZERO) {
+			const uint256_t zero(0);
+			Assert::AreEqual(uint8_t(0), zero.limbCount());
+			Assert::AreEqual(uint16_t(0), zero.bitLength());
+			Assert::AreEqual(uint16_t(256), zero.countLeadingZeros());
+			Assert::AreEqual(uint16_t(256), zero.countTrailingZeros());
+			Assert::AreEqual(uint16_t(0), zero.popcount());
+		}
+
+		TEST_METHOD(SMALL_VALUE_IN_WIDE_TYPE) {
+			const uint512_t a(0x50);
+			Assert::AreEqual(uint8_t(1), a.limbCount());
+			Assert::AreEqual(uint16_t(7), a.bitLength());
+			Assert::AreEqual(uint16_t(505), a.countLeadingZeros());
+			Assert::AreEqual(uint16_t(4), a.countTrailingZeros());
+			Assert::AreEqual(uint16_t(2), a.popcount());
+		}
+
+		TEST_METHOD(MULTI_LIMB) {
+			const uint256_t a = { 0x0, 0x8000000000000001, 0xFFFFFFFFFFFFFFFF, 0x0 };
+			Assert::AreEqual(uint8_t(3), a.limbCount());
+			Assert::AreEqual(uint16_t(192), a.bitLength());
+			Assert::AreEqual(uint16_t(64), a.countLeadingZeros());
+			Assert::AreEqual(uint16_t(64), a.countTrailingZeros());
+			Assert::AreEqual(uint16_t(66), a.popcount());
+		}
+
+		TEST_METHOD(POPCOUNT_WIDE) {
+			uint_array<19> a;	// 2 vector blocks and a scalar tail
+			for (uint8_t i = 0; i < 19; ++i) {
+				a[i] = (i % 3 == 0) ? 0xFFFFFFFFFFFFFFFF : 0x0101010101010101;
+			}
+			Assert::AreEqual(uint16_t(7 * 64 + 12 * 8), a.popcount());
+			Assert::AreEqual(uint16_t(19 * 64), (~uint_array<19>(0)).popcount());
+		}
+	};
+
+	TEST_CLASS(COMPARISON) {
+	public:
+		TEST_METHOD(SAME_WIDTH) {
+			const uint256_t a = { 0x1, 0x0, 0x0, 0x0 };
+			const uint256_t b = { 0x0, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF };
+
+			Assert::IsTrue(a > b);
+			Assert::IsTrue(b < a);
+			Assert::IsTrue(a >= a);
+			Assert::IsTrue(b <= a);
+			Assert::IsFalse(a < a);
+			Assert::IsTrue(a != b);
+			Assert::AreEqual(1, a.ctCompare(b));
+			Assert::AreEqual(-1, b.ctCompare(a));
+			Assert::AreEqual(0, a.ctCompare(a));
+		}
+
+		TEST_METHOD(MIXED_WIDTHS) {
+			const uint512_t wide = { 0x0, 0x0, 0x0, 0x1, 0x0, 0x0, 0x0, 0x0 };
+			const uint256_t narrow = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF };
+
+			Assert::IsTrue(wide > narrow);
+			Assert::IsTrue(narrow < wide);
+			Assert::IsTrue(uint512_t(7) == uint256_t(7));
+			Assert::IsTrue((uint512_t(7) <=> uint256_t(7)) == 0);
+			Assert::AreEqual(1, wide.ctCompare(narrow));
+			Assert::AreEqual(-1, narrow.ctCompare(wide));
+			Assert::AreEqual(0, uint512_t(7).ctCompare(uint256_t(7)));
+		}
+
+		// Differences placed in each vector block and in the scalar tail of a 19 limb value
+		TEST_METHOD(WIDE_EVERY_LIMB) {
+			uint_array<19> base;
+			for (uint8_t i = 0; i < 19; ++i) {
+				base[i] = 0x1000 + i;
+			}
+			for (uint8_t i = 0; i < 19; ++i) {
+				uint_array<19> bigger = base;
+				bigger[i] += 1;
+				Assert::IsTrue(bigger > base);
+				Assert::IsTrue(base < bigger);
+				Assert::AreEqual(1, bigger.ctCompare(base));
+				Assert::AreEqual(-1, base.ctCompare(bigger));
+			}
+			Assert::IsTrue((base <=> base) == 0);
+		}
+	};
+
+	TEST_CLASS(MULTIPLICATION) {
+	public:
+		TEST_METHOD(MULTIPLY_256) {
+			const uint256_t a = { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x8000000000000001, 0xDEADBEEFCAFEBABE };
+			const uint256_t b = { 0x0, 0xFFFFFFFFFFFFFFFF, 0x1234, 0x5 };
+
+			Assert::AreEqual(uint256_t{ 0xAE52B93F6FF914C6, 0x1BA1E60A84A6619D, 0xF2B7A4FB24DF4AA1, 0x5964BAAEF6F9A5B6 }, a * b);
+			Assert::AreEqual(a * b, b * a);
+			Assert::AreEqual(uint256_t(0), a * uint256_t(0));
+		}
+
+		TEST_METHOD(MIXED_WIDTHS) {
+			const uint256_t a = { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x8000000000000001, 0xDEADBEEFCAFEBABE };
+			const uint128_t c = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF };
+
+			Assert::AreEqual(uint256_t{ 0x7EDCBA9876543211, 0xDFD1045754AA88AD, 0x7FFFFFFFFFFFFFFE, 0x2152411035014542 }, a * c);
+			Assert::AreEqual(uint256_t{ 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFE, 0x0, 0x1 }, uint256_t(c) * c);
+		}
+
+		TEST_METHOD(SMALL_VALUES_IN_WIDE_TYPE) {
+			const uint_array<16> a(0xFFFFFFFFFFFFFFFF), b(3);
+			uint_array<16> expected(0xFFFFFFFFFFFFFFFD);
+			expected[1] = 2;
+			Assert::AreEqual(expected, a * b);
+		}
+	};
+
+	TEST_CLASS(BYTE_CONVERSION) {
+	public:
+		TEST_METHOD(BIG_AND_LITTLE_ENDIAN) {
+			const uint128_t a = { 0x0102030405060708, 0x090A0B0C0D0E0F10 };
+			std::array<uint8_t, 16> be = { 0 }, le = { 0 };
+			a.toBytesBE(be);
+			a.toBytesLE(le);
+
+			const std::array<uint8_t, 16> expected = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+			Assert::IsTrue(expected == be);
+			Assert::IsTrue(std::equal(le.rbegin(), le.rend(), expected.begin()));
+			Assert::AreEqual(a, uint128_t::fromBytesBE(be));
+			Assert::AreEqual(a, uint128_t::fromBytesLE(le));
+		}
+
+		// 1024 bits goes through the 32 byte, 16 byte and word paths of reverseBytes
+		TEST_METHOD(ROUND_TRIP_WIDE) {
+			uint_array<16> a;
+			for (uint8_t i = 0; i < 16; ++i) {
+				a[i] = 0x0101010101010101ULL * (i + 1) + i;
+			}
+			std::array<uint8_t, 128> be;
+			a.toBytesBE(be);
+			for (size_t i = 0; i < 128; ++i) {
+				Assert::AreEqual(static_cast<uint8_t>(a[static_cast<char>(15 - i / 8)] >> (8 * (7 - i % 8))), be[i]);
+			}
+			Assert::AreEqual(a, uint_array<16>::fromBytesBE(be));
+
+			std::array<uint8_t, 27> odd;	// Byte reversal with a remainder that is not a whole word
+			for (uint8_t i = 0; i < 27; ++i) {
+				odd[i] = i + 1;
+			}
+			uint_array<16> expected(0);
+			for (uint8_t i = 0; i < 27; ++i) {
+				expected[static_cast<char>(i / 8)] |= static_cast<uint64_t>(27 - i) << (8 * (i % 8));
+			}
+			Assert::AreEqual(expected, uint_array<16>::fromBytesBE(odd));
+		}
+
+		TEST_METHOD(SHORT_INPUT_AND_ERRORS) {
+			const std::array<uint8_t, 3> bytes = { 0x12, 0x34, 0x56 };
+			Assert::AreEqual(uint256_t(0x123456), uint256_t::fromBytesBE(bytes));
+			Assert::AreEqual(uint256_t(0x563412), uint256_t::fromBytesLE(bytes));
+
+			std::array<uint8_t, 33> tooLong = { 0 };
+			Assert::ExpectException<std::out_of_range>([&] { uint256_t::fromBytesBE(tooLong); });
+			std::array<uint8_t, 31> tooShort;
+			Assert::ExpectException<std::out_of_range>([&] { uint256_t(1).toBytesLE(tooShort); });
+		}
+
+		TEST_METHOD(VIEW_IN_PLACE) {
+			alignas(8) std::array<uint8_t, 40> buffer = { 0 };
+			buffer[0] = 0x2A;
+			buffer[8] = 0x01;
+			uint256_t& view = uint256_t::viewMutableLE(buffer);
+			Assert::AreEqual(uint256_t{ 0x0, 0x0, 0x1, 0x2A }, view);
+
+			view += 1;	// Writes straight through to the buffer
+			Assert::AreEqual(uint8_t(0x2B), buffer[0]);
+			Assert::IsTrue(&view == reinterpret_cast<uint256_t*>(buffer.data()));
+			Assert::AreEqual(view, uint256_t::viewLE(std::span<const uint8_t>(buffer)));
+			Assert::ExpectException<std::invalid_argument>([&] { uint256_t::viewLE(std::span<const uint8_t>(buffer.data() + 1, 32)); });
+			Assert::ExpectException<std::out_of_range>([&] { uint256_t::viewMutableLE(std::span<uint8_t>(buffer.data(), 16)); });
+		}
+	};
+}
+
+namespace BCD_CONVERSION {
+	TEST_CLASS(BINARY_TO_BCD) {
+	public:
+		TEST_METHOD(FULL_WIDTH) {
+			const Arr64<4> binary = { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x8000000000000001, 0xDEADBEEFCAFEBABE };
+			const Arr64<5> expected = { 0x51463150772, 0x1405312519378913, 0x3649525996079459, 0x9386867034457120, 0x8783978242685630 };
+			Assert::IsTrue(expected == binaryToBCD(binary));
+		}
+
+		TEST_METHOD(LEADING_ZERO_LIMBS) {
+			const Arr64<4> binary = { 0x0, 0x0, 0x0, 12345678901234567890ULL };
+			const Arr64<5> expected = { 0x0, 0x0, 0x0, 0x1234, 0x5678901234567890 };
+			Assert::IsTrue(expected == binaryToBCD(binary));
+			Assert::IsTrue(Arr64<5>{ 0 } == binaryToBCD(Arr64<4>{ 0 }));
+		}
+	};
+}
+
+namespace EXPRESSION_TEMPLATES {
+	TEST_CLASS(FUSED_ADD_SUB) {
+	public:
+		TEST_METHOD(CHAIN_MATCHES_OPERATORS) {
+			uint256_t a = { 0xFFFFFFFFFFFFFFFF, 0x0, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF };
+			uint256_t b = { 0x0, 0x1, 0x0, 0x1 };
+			uint256_t c = { 0x5, 0xFFFFFFFFFFFFFFFF, 0x0, 0x2 };
+			uint256_t d = { 0x0, 0x0, 0x1234, 0x5678 };
+
+			uint256_t fused = lazy(a) + b - c + d;
+			Assert::AreEqual(a + b - c + d, fused);
+			Assert::AreEqual(a - b - c - d, uint256_t(lazy(a) - b - c - d));
+		}
+
+		TEST_METHOD(MIXED_WIDTHS) {
+			uint256_t a = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF };
+			uint512_t b = { 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x1 };
+			uint256_t c = { 0x0, 0x0, 0x0, 0x7 };
+
+			auto expr = lazy(a) + b - c;
+			static_assert(decltype(expr)::WIDTH == 8, "Width follows maxValue(N, M)");
+			uint512_t fused = expr;
+			Assert::AreEqual(a + b - c, fused);
+		}
+
+		TEST_METHOD(ALIASED_DESTINATION) {
+			uint256_t a = { 0x1, 0x0, 0x0, 0xFFFFFFFFFFFFFFFF };
+			uint256_t b = { 0x0, 0x0, 0x0, 0x2 };
+			const uint256_t expected = a + a - b;
+
+			a = lazy(a) + a - b;
+			Assert::AreEqual(expected, a);
+		}
+	};
 }
 
 // DO NOT CHANGE
@@ -672,3 +1006,273 @@ namespace BITWISE_FUNCTIONS {
 		}
 	};
 }
+
+namespace MODULAR_ARITHMETIC {
+	TEST_CLASS(FIXED_BASE_TABLE) {
+		const uint256_t p25519 = { 0x7FFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFED };
+		const uint256_t exponent = { 0x8B4486C599CB381B, 0x6EB58EEA34854702, 0xA8D4293433E798A0, 0xE81F9B0CBF4E7AF6 };
+		const uint256_t expected = { 0x1467129F79D81080, 0x0376997B394B8737, 0x7CA1D9D2E1096EA2, 0xCAF1F6139E21C0C0 };	// 9^exponent mod p from python
+	public:
+		TEST_METHOD(MODPOW_256) {
+			MontgomeryContext<4> ctx(p25519);
+			Assert::AreEqual(expected, ctx.modPow(uint256_t(9), exponent));
+		}
+
+		TEST_METHOD(COMB_256) {
+			MontgomeryContext<4> ctx(p25519);
+			FixedBaseTable<4> table(ctx, uint256_t(9), 256, 5, 3);
+			Assert::AreEqual(expected, table.pow(exponent));
+			Assert::AreEqual(uint256_t(1), table.pow(0ULL));
+			Assert::AreEqual(uint256_t(81), table.pow(2ULL));
+		}
+
+		TEST_METHOD(COMB_NO_SQUARINGS) {
+			MontgomeryContext<4> ctx(p25519);
+			FixedBaseTable<4> table(ctx, uint256_t(9), 256, 4, 64);	// One comb per column
+			Assert::AreEqual(expected, table.pow(exponent));
+		}
+
+		TEST_METHOD(COMB_512) {
+			const uint512_t m = { 0xBE113028F427D2BB, 0x6DFA23E7A2AC704C, 0x2BEF1F6B80B36714, 0x9F97C413AEF2F88A, 0xBAEC80760AAF3A94, 0x7A2D4F33C3B072E1, 0xF37FE7B9C6BD7881, 0x20BC3FD70E87A553 };
+			const uint512_t b = { 0x24EA816A38E7741B, 0xDAAE3BEAF019DAEE, 0xAAAA3BC8075EE326, 0xDB1E799DF8C4EFB3, 0xB1479939C94B3F4A, 0x33B29589D819C90F, 0xB79BCD2368BD7159, 0xBF6BBB58FC9C2429 };
+			const uint512_t e = { 0x0, 0x0, 0x0, 0x000003E55D415F26, 0x63808AD7F4E89322, 0xC3E8D9DFD6BF76FE, 0x7BB1AE6998F2FFD2, 0x376C1FDF21211A73 };
+			const uint512_t exp = { 0x4715A0267A02D07F, 0xA4FF2F45A7414C52, 0x33D3DA46AAE06897, 0xF9AF8A41EC2D4856, 0x7713ABC491858AAA, 0x5140878FE34C4AB5, 0xC49C65A3AAE29AB7, 0x02D2B826B45A05F0 };
+
+			MontgomeryContext<8> ctx(m);
+			FixedBaseTable<8> table(ctx, b, 300);
+			Assert::AreEqual(exp, table.pow(e));
+			Assert::AreEqual(exp, ctx.modPow(b, e));
+		}
+
+		TEST_METHOD(SERIALIZE_VIEW) {
+			MontgomeryContext<4> ctx(p25519);
+			FixedBaseTable<4> table(ctx, uint256_t(9));
+			std::stringstream ss;
+			table.serialize(ss);
+			const std::string bytes = ss.str();
+			std::vector<uint64_t> buffer(bytes.size() / sizeof(uint64_t));
+			std::memcpy(buffer.data(), bytes.data(), bytes.size());
+			Assert::AreEqual(table.serializedWords(), buffer.size());
+
+			FixedBaseTable<4> view = FixedBaseTable<4>::view(buffer.data(), buffer.size());
+			Assert::AreEqual(expected, view.pow(exponent));
+			FixedBaseTable<4> loaded = FixedBaseTable<4>::deserialize(ss);
+			Assert::AreEqual(expected, loaded.pow(exponent));
+		}
+
+		TEST_METHOD(EVEN_MODULUS_THROWS) {
+			Assert::ExpectException<std::invalid_argument>([] { MontgomeryContext<4> ctx(uint256_t(10)); });
+		}
+	};
+	TEST_CLASS(MULTI_EXPONENTIATION) {
+		const uint256_t p25519 = { 0x7FFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFED };
+
+		static void makeTerms(const size_t count, std::vector<uint256_t>& bases, std::vector<uint256_t>& exponents) {
+			for (uint64_t i = 0; i < count; ++i) {
+				bases.push_back(uint256_t{ 0, 0, i + 1, i * 0x9E3779B97F4A7C15ULL });
+				exponents.push_back(uint256_t{ 0, 0, 0x9E3779B97F4A7C15ULL * (i + 1), 0xD1B54A32D192ED03ULL * (i + 7) });
+			}
+		}
+	public:
+		TEST_METHOD(STRAUS_5_TERMS) {	// Expected values from python
+			MontgomeryContext<4> ctx(p25519);
+			std::vector<uint256_t> bases, exponents;
+			makeTerms(5, bases, exponents);
+			const uint256_t expected = { 0x3140946D85BFD700, 0x4E7B12C195754B30, 0x8EDD5DD6520FD41B, 0x98173AD7C7A37858 };
+
+			Assert::AreEqual(expected, multiExponentiate(ctx, bases, exponents));
+			Assert::AreEqual(expected, multiExponentiatePippenger(ctx, bases.data(), exponents.data(), bases.size()));
+		}
+
+		TEST_METHOD(PIPPENGER_40_TERMS) {
+			MontgomeryContext<4> ctx(p25519);
+			std::vector<uint256_t> bases, exponents;
+			makeTerms(40, bases, exponents);
+			const uint256_t expected = { 0x76748C83E4A38081, 0xDBDFA7221E5FB0F8, 0xB63A6C6A4659C341, 0x3B2BE387736B9D9A };
+
+			Assert::AreEqual(expected, multiExponentiate(ctx, bases, exponents));
+			Assert::AreEqual(expected, multiExponentiateStraus(ctx, bases.data(), exponents.data(), bases.size()));
+		}
+
+		TEST_METHOD(ZERO_EXPONENTS) {
+			MontgomeryContext<4> ctx(p25519);
+			std::vector<uint256_t> bases = { uint256_t(3), uint256_t(5) };
+			std::vector<uint256_t> exponents = { uint256_t(0), uint256_t(0) };
+			Assert::AreEqual(uint256_t(1), multiExponentiate(ctx, bases, exponents));
+		}
+	};
+}
+
+namespace PARALLEL {
+	TEST_CLASS(PARALLEL_EXECUTOR) {
+	public:
+		TEST_METHOD(SUBMIT_AWAIT) {
+			ParallelExecutor executor(4, false);
+			auto future = executor.submit([] { return uint256_t{ 1, 2, 3, 4 } + uint256_t{ 4, 3, 2, 1 }; });
+			Assert::AreEqual(uint256_t{ 5, 5, 5, 5 }, executor.await(future));
+		}
+
+		TEST_METHOD(NESTED_SUBMIT) {
+			ParallelExecutor executor(2, false);
+			auto outer = executor.submit([&executor] {
+				std::vector<std::future<uint64_t>> inner;
+				for (uint64_t i = 0; i < 16; ++i) {
+					inner.push_back(executor.submit([i] { return i * i; }));
+				}
+				uint64_t sum = 0;
+				for (auto& future : inner) {
+					sum += executor.await(future);
+				}
+				return sum;
+			});
+			Assert::AreEqual(uint64_t(1240), executor.await(outer));
+		}
+
+		TEST_METHOD(PARALLEL_MODPOW) {
+			const uint256_t p25519 = { 0x7FFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFED };
+			MontgomeryContext<4> ctx(p25519);
+			std::vector<uint256_t> bases, exponents;
+			for (uint64_t i = 0; i < 100; ++i) {
+				bases.push_back(uint256_t{ 0, i, 0, i + 2 });
+				exponents.push_back(uint256_t{ 0, 0, i * 0x9E3779B97F4A7C15ULL, i + 3 });
+			}
+
+			ParallelExecutor executor(4);
+			const std::vector<uint256_t> results = parallelModPow(executor, p25519, bases, exponents);
+			for (size_t i = 0; i < bases.size(); ++i) {
+				Assert::AreEqual(ctx.modPow(bases[i], exponents[i]), results[i]);
+			}
+		}
+	};
+	TEST_CLASS(SCRATCH_ARENA) {
+	public:
+		TEST_METHOD(FRAME_RELEASES) {
+			ScratchArena arena;
+			{
+				ScratchArena::Frame outer(arena);
+				uint1024_t* a = arena.allocate<uint1024_t>(4);
+				a[3] = uint1024_t(7);
+				const size_t afterOuter = arena.bytesInUse();
+				{
+					ScratchArena::Frame inner(arena);
+					arena.allocate<uint1024_t>(1000);	// Forces a second block
+				}
+				Assert::AreEqual(afterOuter, arena.bytesInUse());
+				Assert::AreEqual(uint1024_t(7), a[3]);
+			}
+			Assert::AreEqual(size_t(0), arena.bytesInUse());
+			Assert::IsTrue(arena.peakBytes() >= 1004 * sizeof(uint1024_t));
+		}
+
+		TEST_METHOD(BLOCKS_REUSED) {
+			ScratchArena arena;
+			for (int i = 0; i < 3; ++i) {
+				ScratchArena::Frame frame(arena);
+				arena.allocate<uint512_t>(2000);
+			}
+			const size_t capacity = arena.capacity();
+			{
+				ScratchArena::Frame frame(arena);
+				arena.allocate<uint512_t>(2000);
+			}
+			Assert::AreEqual(capacity, arena.capacity());
+		}
+	};
+}
+
+namespace TEXT_CODECS {
+	TEST_CLASS(HEX_AND_BASE64) {
+	private:
+		static std::vector<uint8_t> randomBytes(const size_t count) {
+			std::vector<uint8_t> bytes(count);
+			uint64_t state = count;
+			for (auto& byte : bytes) {
+				state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+				byte = static_cast<uint8_t>(state >> 56);
+			}
+			return bytes;
+		}
+
+	public:
+		TEST_METHOD(RFC_4648_VECTORS) {
+			const std::string_view inputs[] = { "", "f", "fo", "foo", "foob", "fooba", "foobar" };
+			const std::string_view expected[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+			for (size_t i = 0; i < 7; ++i) {
+				char out[8];
+				base64Encode(reinterpret_cast<const uint8_t*>(inputs[i].data()), inputs[i].size(), out);
+				Assert::IsTrue(expected[i] == std::string_view(out, expected[i].size()));
+
+				uint8_t decoded[8];
+				const size_t count = base64Decode(expected[i], decoded, sizeof(decoded));
+				Assert::IsTrue(inputs[i] == std::string_view(reinterpret_cast<const char*>(decoded), count));
+			}
+		}
+
+		// Lengths chosen to hit the AVX2 blocks, the SSSE3 blocks and the scalar tail
+		TEST_METHOD(SIMD_MATCHES_SCALAR) {
+			for (const size_t count : { 1, 15, 16, 31, 32, 47, 48, 63, 64, 100, 257 }) {
+				const std::vector<uint8_t> bytes = randomBytes(count);
+
+				std::string hex(2 * count, ' '), hexScalar(2 * count, ' ');
+				hexEncode(bytes.data(), count, hex.data());
+				hexEncodeScalar(bytes.data(), count, hexScalar.data());
+				Assert::IsTrue(hexScalar == hex);
+
+				std::vector<uint8_t> decoded(count);
+				Assert::IsTrue(hexDecode(hex.data(), count, decoded.data()));
+				Assert::IsTrue(bytes == decoded);
+				for (char& c : hex) {
+					c = static_cast<char>(std::toupper(c));
+				}
+				Assert::IsTrue(hexDecode(hex.data(), count, decoded.data()));
+				Assert::IsTrue(bytes == decoded);
+
+				std::string b64(base64EncodedLength(count), ' ');
+				base64Encode(bytes.data(), count, b64.data());
+				std::string b64Scalar(base64EncodedLength(count), ' ');
+				base64EncodeScalar(bytes.data(), count / 3 * 3, b64Scalar.data());
+				Assert::IsTrue(b64Scalar.substr(0, count / 3 * 4) == b64.substr(0, count / 3 * 4));
+
+				std::vector<uint8_t> decoded64(count + 32);
+				Assert::AreEqual(count, base64Decode(b64, decoded64.data(), decoded64.size()));
+				Assert::IsTrue(std::equal(bytes.begin(), bytes.end(), decoded64.begin()));
+			}
+		}
+
+		TEST_METHOD(INVALID_INPUT) {
+			std::string hex(64, 'a');
+			uint8_t out[64];
+			hex[41] = 'g';	// Inside the second half of an AVX2 block
+			Assert::IsFalse(hexDecode(hex.data(), 32, out));
+			hex[41] = 'a';
+			hex[63] = '/';
+			Assert::IsFalse(hexDecode(hex.data(), 32, out));
+
+			std::string b64(64, 'Q');
+			b64[20] = '*';
+			Assert::ExpectException<std::invalid_argument>([&] { base64Decode(b64, out, sizeof(out)); });
+			Assert::ExpectException<std::invalid_argument>([&] { base64Decode("QUJD=", out, sizeof(out)); });
+			Assert::ExpectException<std::out_of_range>([&] { base64Decode("QUJDRA==", out, 3); });
+		}
+
+		TEST_METHOD(UINT_ARRAY_ROUND_TRIP) {
+			const uint256_t a = { 0x0123456789ABCDEF, 0xFEDCBA9876543210, 0x8000000000000001, 0xDEADBEEFCAFEBABE };
+			char hex[HEX_LENGTH<4>];
+			Assert::AreEqual(size_t(64), toHex(a, hex));
+			Assert::IsTrue(std::string_view("0123456789abcdeffedcba98765432108000000000000001deadbeefcafebabe") == std::string_view(hex, 64));
+			Assert::AreEqual(a, fromHex<4>(std::string_view(hex, 64)));
+			Assert::AreEqual(uint256_t(0xABC), fromHex<4>("abc"));
+			Assert::AreEqual(uint256_t(0xABC), fromHex<4>("0ABC"));
+
+			char b64[BASE64_LENGTH<4>];
+			Assert::AreEqual(size_t(44), toBase64(a, b64));
+			Assert::IsTrue(std::string_view("ASNFZ4mrze/+3LqYdlQyEIAAAAAAAAAB3q2+78r+ur4=") == std::string_view(b64, 44));
+			Assert::AreEqual(a, fromBase64<4>(std::string_view(b64, 44)));
+			Assert::AreEqual(uint256_t(0x666F6F), fromBase64<4>("Zm9v"));
+
+			Assert::ExpectException<std::out_of_range>([&] { fromHex<2>(std::string(33, '1')); });
+			Assert::ExpectException<std::invalid_argument>([&] { fromHex<2>("12x4"); });
+			Assert::ExpectException<std::out_of_range>([&] { toHex(a, std::span<char>(hex, 63)); });
+		}
+	};
+}
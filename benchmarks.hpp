@@ -0,0 +1,167 @@
+// Author: Marek Oczadly
+// License: MIT
+// benchmarks.hpp
+
+#pragma once
+#include <cstdint>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <array>
+#include <string>
+#include <vector>
+#include "largeInt.hpp"
+#include "montgomery.hpp"
+#include "exponentiation.hpp"
+#include "scratch-arena.hpp"
+#include "expression-templates.hpp"
+
+
+struct BenchmarkResult {
+	std::string name;
+	double nanosecondsPerOp;
+	size_t peakScratchBytes;	// Highest ScratchArena use of a single operation
+};
+
+/// @brief Stops the optimiser from discarding a result that is never read
+template <typename T>
+inline void doNotOptimize(const T& value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	const volatile char sink = *reinterpret_cast<const volatile char*>(&value);
+	(void)sink;
+#endif
+}
+
+/// @brief Deterministic pseudo-random fill (splitmix64) so runs are comparable
+inline uint64_t benchmarkRandom(uint64_t& state) noexcept {
+	uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+template <uint8_t N>
+inline uint_array<N> randomUintArray(uint64_t& state) noexcept {
+	uint_array<N> value;
+	for (auto& limb : value.limbs()) {
+		limb = benchmarkRandom(state);
+	}
+	return value;
+}
+
+/// @brief Times op() over a number of iterations and records the peak scratch memory of one call
+template <typename F>
+BenchmarkResult benchmark(const std::string& name, const size_t iterations, F&& op) {
+	ScratchArena& arena = ScratchArena::local();
+	arena.resetPeak();
+	const size_t baseline = arena.bytesInUse();
+	doNotOptimize(op());	// Warm up (and fault in the arena blocks)
+	const size_t peak = arena.peakBytes() - baseline;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; ++i) {
+		doNotOptimize(op());
+	}
+	const auto end = std::chrono::steady_clock::now();
+	const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	return BenchmarkResult{ name, ns / static_cast<double>(iterations), peak };
+}
+
+inline void printBenchmark(std::ostream& os, const BenchmarkResult& result) {
+	os << std::left << std::setw(40) << result.name
+	   << std::right << std::setw(14) << std::fixed << std::setprecision(1) << result.nanosecondsPerOp << " ns/op"
+	   << std::setw(10) << result.peakScratchBytes << " B peak" << NEWL;
+}
+
+template <uint8_t N>
+void benchmarkExponentiation(std::ostream& os, const size_t iterations) {
+	uint64_t state = N;
+	uint_array<N> modulus = randomUintArray<N>(state);
+	modulus.limbs()[0] |= 1U;
+	modulus.limbs()[N - 1] |= 1ULL << 63;
+	const MontgomeryContext<N> ctx(modulus);
+	const uint_array<N> base = randomUintArray<N>(state);
+	const uint_array<N> exponent = randomUintArray<N>(state);
+	const std::string bits = std::to_string(64 * N);
+
+	printBenchmark(os, benchmark("modPow " + bits, iterations, [&] {
+		return ctx.modPow(base, exponent);
+	}));
+
+	const FixedBaseTable<N> table(ctx, base);
+	printBenchmark(os, benchmark("FixedBaseTable::pow " + bits, iterations, [&] {
+		return table.pow(exponent);
+	}));
+
+	for (const size_t count : { size_t(8), size_t(64) }) {
+		std::vector<uint_array<N>> bases, exponents;
+		for (size_t i = 0; i < count; ++i) {
+			bases.push_back(randomUintArray<N>(state));
+			exponents.push_back(randomUintArray<N>(state));
+		}
+		printBenchmark(os, benchmark("multiExponentiate " + bits + " x" + std::to_string(count), std::max<size_t>(1, iterations / count), [&] {
+			return multiExponentiate(ctx, bases, exponents);
+		}));
+	}
+}
+
+template <uint8_t N>
+void benchmarkAddSubChain(std::ostream& os, const size_t iterations) {
+	uint64_t state = N;
+	const uint_array<N> a = randomUintArray<N>(state), b = randomUintArray<N>(state);
+	const uint_array<N> c = randomUintArray<N>(state), d = randomUintArray<N>(state);
+	const std::string bits = std::to_string(64 * N);
+
+	printBenchmark(os, benchmark("a + b - c + d " + bits, iterations, [&] {
+		return a + b - c + d;
+	}));
+	printBenchmark(os, benchmark("lazy(a) + b - c + d " + bits, iterations, [&] {
+		return uint_array<N>(lazy(a) + b - c + d);
+	}));
+}
+
+/// @brief Single limb values in an N limb type - the case LARGE_INT_NORMALIZED_LENGTH and the BCD leading zero skip target
+template <uint8_t N>
+void benchmarkSmallValues(std::ostream& os, const size_t iterations) {
+	uint64_t state = N;
+	const uint_array<N> a(benchmarkRandom(state)), b(benchmarkRandom(state));
+	const std::string bits = std::to_string(64 * N);
+
+	printBenchmark(os, benchmark("small a + b " + bits, iterations, [&] {
+		return a + b;
+	}));
+	printBenchmark(os, benchmark("small a * b " + bits, iterations, [&] {
+		return a * b;
+	}));
+	printBenchmark(os, benchmark("small toString " + bits, std::max<size_t>(1, iterations / 100), [&] {
+		return a.toString();
+	}));
+}
+
+template <uint8_t N>
+void benchmarkByteConversion(std::ostream& os, const size_t iterations) {
+	uint64_t state = N;
+	const uint_array<N> a = randomUintArray<N>(state);
+	std::array<uint8_t, 8U * N> bytes;
+	const std::string bits = std::to_string(64 * N);
+
+	printBenchmark(os, benchmark("toBytesBE " + bits, iterations, [&] {
+		a.toBytesBE(bytes);
+		return bytes[0];
+	}));
+	printBenchmark(os, benchmark("fromBytesBE " + bits, iterations, [&] {
+		return uint_array<N>::fromBytesBE(bytes);
+	}));
+}
+
+inline void runBenchmarks(std::ostream& os) {
+	benchmarkAddSubChain<4>(os, 1000000);
+	benchmarkAddSubChain<64>(os, 100000);
+	benchmarkSmallValues<16>(os, 1000000);
+	benchmarkByteConversion<64>(os, 1000000);
+	benchmarkExponentiation<4>(os, 2000);
+	benchmarkExponentiation<16>(os, 100);
+	benchmarkExponentiation<32>(os, 20);
+}
@@ -4,8 +4,14 @@
 
 #pragma once
 #include <cstdint>
+#include <cstring>
 #include <array>
 #include "utils.hpp"
+#include "math-intrinsics.hpp"
+
+#if defined(__SSSE3__) || defined(__AVX2__) || defined(__AVX512F__)
+#	include <immintrin.h>
+#endif
 
 
 constexpr uint64_t CEIL(const double value) noexcept {
@@ -38,10 +44,10 @@ constexpr uint8_t Arr64FromStrnLength(const uint16_t strnlen) noexcept {
 	return CEIL(static_cast<double>(strnlen * 4.0) / 64.0);
 }
 
-template <uint8_t N>
+template <size_t N>
 using Arr64 = std::array<uint64_t, N>;
 
-template <uint8_t N>
+template <size_t N>
 inline Arr64<N> leftShift(const Arr64<N>& arr, const uint16_t places) noexcept {
 	if constexpr (N == 1) {	// Evaluated at compile time so no performance impact
 		return Arr64<N>{ arr[0] << places };
@@ -73,7 +79,7 @@ inline Arr64<N> leftShift(const Arr64<N>& arr, const uint16_t places) noexcept {
 	}
 }
 
-template <uint8_t N>
+template <size_t N>
 inline void leftShiftInPlace(Arr64<N>& arr, const uint16_t places) noexcept {
 	if constexpr (N == 1) {
 		arr[0] <<= places;
@@ -111,7 +117,55 @@ inline void leftShiftInPlace(Arr64<N>& arr, const uint16_t places) noexcept {
 }
 
 
-template <uint8_t N, uint16_t PLACES>
+template <size_t N>
+inline void rightShiftInPlace(Arr64<N>& arr, const uint16_t places) noexcept {
+	if constexpr (N == 0) {
+		return;
+	}
+	else if constexpr (N == 1) {
+		arr[0] = (places >= 64U) ? 0 : (arr[0] >> places);
+		return;
+	}
+	else {
+		if (places >= 64U * N) {
+			arr.fill(0);
+			return;
+		}
+		if (places == 0) {
+			return;
+		}
+		const uint8_t interWordShifts = places / 64U;
+		const uint8_t intraWordShiftsR = places % 64U;
+		if (intraWordShiftsR == 0) {
+			for (int16_t i = N - 1; i >= interWordShifts; --i) {
+				arr[i] = arr[i - interWordShifts];
+			}
+		}
+		else {
+			const uint8_t intraWordShiftsL = 64U - intraWordShiftsR;
+			uint64_t low, high = arr[N - interWordShifts - 1] >> intraWordShiftsR;
+			for (int16_t i = N - 1; i > interWordShifts; --i) {
+				low = arr[i - interWordShifts - 1] << intraWordShiftsL;
+				arr[i] = high | low;
+				high = arr[i - interWordShifts - 1] >> intraWordShiftsR;
+			}
+			arr[interWordShifts] = high;
+		}
+		for (uint8_t i = 0; i < interWordShifts; ++i) {
+			arr[i] = 0;
+		}
+	}
+}
+
+template <size_t N>
+inline Arr64<N> rightShift(const Arr64<N>& arr, const uint16_t places) noexcept {
+	Arr64<N> returnVal = arr;
+	rightShiftInPlace(returnVal, places);
+	return returnVal;
+}
+
+
+template <size_t N, uint16_t PLACES>
 inline Arr64<N> leftShift(const Arr64<N>& arr) noexcept {
 	if constexpr (N == 0) {
 		return Arr64<N>{};
@@ -167,7 +221,7 @@ inline Arr64<N> leftShift(const Arr64<N>& arr) noexcept {
 }
 
 
-template <uint8_t N, uint16_t PLACES>
+template <size_t N, uint16_t PLACES>
 inline void leftShiftInPlace(Arr64<N>& arr) noexcept {
 	if constexpr(N == 0) {
 		return;
@@ -221,7 +275,7 @@ inline void leftShiftInPlace(Arr64<N>& arr) noexcept {
 	}
 }
 
-template <uint8_t N, uint16_t PLACES>
+template <size_t N, uint16_t PLACES>
 inline void rightShiftInPlace(Arr64<N>& arr) noexcept {
 	if constexpr (N == 0) {
 		return;
@@ -268,7 +322,186 @@ inline void rightShiftInPlace(Arr64<N>& arr) noexcept {
 	}
 }
 
-template <uint8_t N>
+
+/*
+	======================= LIMB SHIFTS =======================
+	The functions above treat index 0 as the most significant word. The ones below work on the uint_array layout
+	(index 0 least significant) and take the shift amount at runtime. out may alias in.
+	For N >= 8 the body runs 8 (AVX-512) or 4 (AVX2) limbs per step as a funnel shift of two overlapping loads -
+	vpshldvq / vpshrdvq when AVX512-VBMI2 is available, otherwise a shift pair and an OR.
+*/
+
+template <size_t N>
+inline void shiftLimbsLeft(Arr64<N>& out, const Arr64<N>& in, const uint16_t places) noexcept {
+	if (places >= 64U * N) {
+		out.fill(0);
+		return;
+	}
+	const size_t words = places / 64U;
+	const uint8_t bits = places % 64U;
+	size_t i = N;	// Limbs [i, N) are done. Top down so the limbs still to be read are never overwritten
+	if (bits == 0) {
+		for (; i > words; --i) {
+			out[i - 1] = in[i - 1 - words];
+		}
+	}
+	else {
+		if constexpr (N >= 8) {
+#if defined(__AVX512F__)
+#	if defined(__AVX512VBMI2__)
+			const __m512i count = _mm512_set1_epi64(bits);
+#	else
+			const __m128i countL = _mm_cvtsi32_si128(bits), countR = _mm_cvtsi32_si128(64 - bits);
+#	endif
+			for (; i >= words + 9; i -= 8) {
+				const __m512i high = _mm512_loadu_si512(in.data() + i - 8 - words);
+				const __m512i low = _mm512_loadu_si512(in.data() + i - 9 - words);
+#	if defined(__AVX512VBMI2__)
+				_mm512_storeu_si512(out.data() + i - 8, _mm512_shldv_epi64(high, low, count));
+#	else
+				_mm512_storeu_si512(out.data() + i - 8, _mm512_or_si512(_mm512_sll_epi64(high, countL), _mm512_srl_epi64(low, countR)));
+#	endif
+			}
+#elif defined(__AVX2__)
+			const __m128i countL = _mm_cvtsi32_si128(bits), countR = _mm_cvtsi32_si128(64 - bits);
+			for (; i >= words + 5; i -= 4) {
+				const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.data() + i - 4 - words));
+				const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.data() + i - 5 - words));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + i - 4),
+					_mm256_or_si256(_mm256_sll_epi64(high, countL), _mm256_srl_epi64(low, countR)));
+			}
+#endif
+		}
+		for (; i > words + 1; --i) {
+			out[i - 1] = (in[i - 1 - words] << bits) | (in[i - 2 - words] >> (64U - bits));
+		}
+		out[words] = in[0] << bits;
+		i = words;
+	}
+	for (; i > 0; --i) {
+		out[i - 1] = 0;
+	}
+}
+
+template <size_t N>
+inline void shiftLimbsRight(Arr64<N>& out, const Arr64<N>& in, const uint16_t places) noexcept {
+	if (places >= 64U * N) {
+		out.fill(0);
+		return;
+	}
+	const size_t words = places / 64U;
+	const uint8_t bits = places % 64U;
+	const size_t kept = N - words;	// Limbs that still receive bits
+	size_t i = 0;	// Limbs [0, i) are done. Bottom up so the limbs still to be read are never overwritten
+	if (bits == 0) {
+		for (; i < kept; ++i) {
+			out[i] = in[i + words];
+		}
+	}
+	else {
+		if constexpr (N >= 8) {
+#if defined(__AVX512F__)
+#	if defined(__AVX512VBMI2__)
+			const __m512i count = _mm512_set1_epi64(bits);
+#	else
+			const __m128i countR = _mm_cvtsi32_si128(bits), countL = _mm_cvtsi32_si128(64 - bits);
+#	endif
+			for (; i + 9 <= kept; i += 8) {
+				const __m512i low = _mm512_loadu_si512(in.data() + i + words);
+				const __m512i high = _mm512_loadu_si512(in.data() + i + words + 1);
+#	if defined(__AVX512VBMI2__)
+				_mm512_storeu_si512(out.data() + i, _mm512_shrdv_epi64(low, high, count));
+#	else
+				_mm512_storeu_si512(out.data() + i, _mm512_or_si512(_mm512_srl_epi64(low, countR), _mm512_sll_epi64(high, countL)));
+#	endif
+			}
+#elif defined(__AVX2__)
+			const __m128i countR = _mm_cvtsi32_si128(bits), countL = _mm_cvtsi32_si128(64 - bits);
+			for (; i + 5 <= kept; i += 4) {
+				const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.data() + i + words));
+				const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in.data() + i + words + 1));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + i),
+					_mm256_or_si256(_mm256_srl_epi64(low, countR), _mm256_sll_epi64(high, countL)));
+			}
+#endif
+		}
+		for (; i + 1 < kept; ++i) {
+			out[i] = (in[i + words] >> bits) | (in[i + words + 1] << (64U - bits));
+		}
+		out[kept - 1] = in[N - 1] >> bits;
+		i = kept;
+	}
+	for (; i < N; ++i) {
+		out[i] = 0;
+	}
+}
+
+/// @brief out[i] = in[count - 1 - i]. Turns the little-endian limb memory into a big-endian byte string and back.
+/// 32 bytes per step with AVX2, 16 with SSSE3 (pshufb), then bswap on whole words. in and out must not overlap
+inline void reverseBytes(uint8_t* out, const uint8_t* in, const size_t count) noexcept {
+	size_t i = 0;
+#if defined(__AVX2__)
+	const __m256i reverse256 = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+												15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	for (; i + 32 <= count; i += 32) {
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + count - i - 32));
+		// pshufb only reverses within each 16 byte lane, so the lanes are swapped afterwards
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(_mm256_shuffle_epi8(bytes, reverse256), 0x4E));
+	}
+#endif
+#if defined(__SSSE3__) || defined(__AVX2__)
+	const __m128i reverse128 = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	for (; i + 16 <= count; i += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + count - i - 16));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(bytes, reverse128));
+	}
+#endif
+	for (; i + 8 <= count; i += 8) {
+		uint64_t word;
+		std::memcpy(&word, in + count - i - 8, 8);
+		word = byteSwap64(word);
+		std::memcpy(out + i, &word, 8);
+	}
+	for (; i < count; ++i) {
+		out[i] = in[count - 1 - i];
+	}
+}
+
+/// @brief Compares N limbs (index 0 least significant) from the top down and stops at the first difference.
+/// Returns -1, 0 or 1. For N >= 8 each step tests 8 (AVX-512) or 4 (AVX2) limbs for equality in one instruction
+template <size_t N>
+inline int compareLimbs(const uint64_t* a, const uint64_t* b) noexcept {
+	size_t i = N;	// Limbs [i, N) are equal
+	if constexpr (N >= 8) {
+#if defined(__AVX512F__)
+		for (; i >= 8; i -= 8) {
+			const __mmask8 differ = _mm512_cmpneq_epu64_mask(_mm512_loadu_si512(a + i - 8), _mm512_loadu_si512(b + i - 8));
+			if (differ != 0) {
+				const size_t idx = i - 8 + 31 - std::countl_zero(static_cast<uint32_t>(differ));
+				return (a[idx] > b[idx]) ? 1 : -1;
+			}
+		}
+#elif defined(__AVX2__)
+		for (; i >= 4; i -= 4) {
+			const __m256i equal = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 4)),
+													 _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i - 4)));
+			const uint32_t differ = ~static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(equal))) & 0xFU;
+			if (differ != 0) {
+				const size_t idx = i - 4 + 31 - std::countl_zero(differ);
+				return (a[idx] > b[idx]) ? 1 : -1;
+			}
+		}
+#endif
+	}
+	for (; i > 0; --i) {
+		if (a[i - 1] != b[i - 1]) {
+			return (a[i - 1] > b[i - 1]) ? 1 : -1;
+		}
+	}
+	return 0;
+}
+
+template <size_t N>
 void setNibble(Arr64<N>& arr, const uint16_t nibbleIdx, const uint8_t value) noexcept {
 	// No bounds checking for performance. Only used internally with valid indices.
 	const uint8_t wordIdx = nibbleIdx / 16U;
@@ -279,7 +512,7 @@ void setNibble(Arr64<N>& arr, const uint16_t nibbleIdx, const uint8_t value) noe
 	byte |= (value & 0x0F) << (isLowerNibble ? 0 : 4);	// Set the target nibble
 }
 
-template <uint8_t N>
+template <size_t N>
 std::wstring byteArrayToBinaryString(const Arr64<N>& arr) noexcept {
 	std::wstringstream ss;
 	ss << L'\n' << L'{';
@@ -291,7 +524,7 @@ std::wstring byteArrayToBinaryString(const Arr64<N>& arr) noexcept {
 	return ss.str();
 }
 
-template <uint8_t N>
+template <size_t N>
 inline uint8_t getBit(const Arr64<N>& arr, const uint16_t idx) noexcept {
 	// No bounds checking for performance. Only used internally with valid indices.
 #ifdef _DEBUG
@@ -306,7 +539,7 @@ inline uint8_t getBit(const Arr64<N>& arr, const uint16_t idx) noexcept {
 #endif
 }
 
-template <uint16_t IDX, uint8_t N>
+template <uint16_t IDX, size_t N>
 inline uint8_t getBitCompiletime(const Arr64<N>& arr) noexcept {
 	static_assert(IDX < N * 64U, "Index out of bounds in getBit<>.");	// Compile-time check so no performance impact
 	constexpr uint8_t arrPos = IDX / 64U;
@@ -371,24 +604,37 @@ inline void sub3Module(uint64_t& bcd_word) noexcept {
 	sub3Module(byte_arr[7]);
 }
 
-template <uint8_t N>
+template <size_t N>
 inline Arr64<UINT64_BCD_ARRAY_SIZE(N)> binaryToBCD(const Arr64<N>& arr) noexcept {
 	constexpr auto BCD_SIZE_BITS = BCD_BITWIDTH(64ULL * N);
 	constexpr auto BCD_ARR_WIDTH = UINT64_BCD_ARRAY_SIZE(N);
 
 	std::array<uint64_t, BCD_ARR_WIDTH> bcdArray = { 0 };
-	
-	for (uint16_t j = 0; j < N * 64U; ++j) {
-		loopUnroll(BCD_ARR_WIDTH)
+
+	// Leading zero bits leave the BCD value at 0, so start from the most significant set bit
+	uint16_t start = 0;
+	while (start < N * 64U && arr[start / 64U] == 0) {
+		start += 64U;
+	}
+	if (start < N * 64U) {
+		start += std::countl_zero(arr[start / 64U]);
+	}
+
+	for (uint16_t j = start; j < N * 64U; ++j) {
+		// The digits of a k bit value fit in 1.21k + 4 bits, so only the last (j - start + 1) / 48 + 1 words can be non-zero yet
+		const size_t first = BCD_ARR_WIDTH - std::min<size_t>(BCD_ARR_WIDTH, (j - start + 1U) / 48U + 1U);
+		for (size_t i = first; i < BCD_ARR_WIDTH; ++i) {
 			add3Module(bcdArray[i]);
-		endLoop
-		leftShiftInPlace<BCD_ARR_WIDTH, 1>(bcdArray);
-		bcdArray[BCD_ARR_WIDTH - 1] |= getBit(arr, j);
+		}
+		for (size_t i = first; i + 1 < BCD_ARR_WIDTH; ++i) {
+			bcdArray[i] = (bcdArray[i] << 1) | (bcdArray[i + 1] >> 63);
+		}
+		bcdArray[BCD_ARR_WIDTH - 1] = (bcdArray[BCD_ARR_WIDTH - 1] << 1) | getBit(arr, j);
 	}
 	return bcdArray;
 }
 
-template <uint8_t N>
+template <size_t N>
 inline Arr64<BINARY_ARR64_SIZE_BCD(N)> BCDToBinary(Arr64<N>& bcdArr) noexcept {
 	constexpr auto BINARY_SIZE_BITS = BINARY_BITWIDTH_FROM_BCD(64ULL * N);
 	constexpr auto BINARY_ARR_WIDTH = BINARY_ARR64_SIZE_BCD(N);
@@ -0,0 +1,348 @@
+// Author: Marek Oczadly
+// License: MIT
+// exponentiation.hpp
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include "utils.hpp"
+#include "largeInt.hpp"
+#include "montgomery.hpp"
+#include "scratch-arena.hpp"
+
+
+/// @brief Lim-Lee comb table for repeated exponentiation of one fixed base modulo one fixed modulus.
+/// The exponent is split into `teeth` rows of `rowLength` bits and each row into `combs` blocks of `combSpacing` bits.
+/// Memory: combs * 2^teeth entries. Cost per exponentiation: combSpacing - 1 squarings and at most rowLength multiplications.
+/// Setting combs == rowLength removes every squaring (fixed-base windowing) at the cost of the largest table.
+template <uint8_t N>
+class FixedBaseTable {
+	static_assert(sizeof(uint_array<N>) == sizeof(uint64_t) * N, "uint_array must be tightly packed to be serialized in place");
+private:
+	static constexpr uint64_t SERIAL_MAGIC = 0x3142415445534142ULL;	// "BASETAB1" in little endian
+	static constexpr size_t HEADER_WORDS = 5;	// magic, N, exponentBits, teeth, combs
+
+	MontgomeryContext<N> context;
+	uint16_t exponentBits;
+	uint8_t teeth;
+	uint16_t combs;
+	uint16_t rowLength;		// ceil(exponentBits / teeth)
+	uint16_t combSpacing;	// ceil(rowLength / combs)
+	std::vector<uint_array<N>> ownedEntries;
+	const uint_array<N>* viewEntries = nullptr;	// Set when the table lives in an external (e.g. memory mapped) buffer
+
+	inline const uint_array<N>* entries() const noexcept {
+		return ownedEntries.empty() ? viewEntries : ownedEntries.data();
+	}
+
+	inline size_t entryCount() const noexcept {
+		return static_cast<size_t>(combs) << teeth;
+	}
+
+	void setLayout(const uint16_t bits, const uint8_t teethCount, const uint16_t combCount) {
+		if (bits == 0 || bits > 64U * 128U) {
+			throw std::invalid_argument("Exponent bit width must be between 1 and 8192.");
+		}
+		if (teethCount == 0 || teethCount > 16) {
+			throw std::invalid_argument("Number of teeth must be between 1 and 16.");
+		}
+		exponentBits = bits;
+		teeth = teethCount;
+		rowLength = static_cast<uint16_t>((bits + teethCount - 1) / teethCount);
+		if (combCount == 0 || combCount > rowLength) {
+			throw std::invalid_argument("Number of combs must be between 1 and the row length.");
+		}
+		combs = combCount;
+		combSpacing = static_cast<uint16_t>((rowLength + combCount - 1) / combCount);
+	}
+
+	static std::vector<uint64_t> headerWords(const uint_array<N>& modulus, const uint16_t bits, const uint8_t teethCount, const uint16_t combCount) {
+		std::vector<uint64_t> header = { SERIAL_MAGIC, N, bits, teethCount, combCount };
+		header.insert(header.end(), modulus.limbs().begin(), modulus.limbs().end());
+		return header;
+	}
+
+	explicit FixedBaseTable(const MontgomeryContext<N>& ctx) : context(ctx) {}
+
+public:
+	/// @brief Precomputes the comb table for base modulo ctx.modulus()
+	/// @param ctx Montgomery context of the modulus. Copied into the table
+	/// @param base The fixed base
+	/// @param maxExponentBits Largest exponent bit width pow() will accept
+	/// @param teethCount Rows per comb. Each extra tooth doubles the table and removes work from every exponentiation
+	/// @param combCount Number of shifted combs. Each extra comb adds 2^teeth entries and removes rowLength / combs squarings
+	FixedBaseTable(const MontgomeryContext<N>& ctx, const uint_array<N>& base,
+				   const uint16_t maxExponentBits = 64U * N, const uint8_t teethCount = 6, const uint16_t combCount = 4) : context(ctx) {
+		setLayout(maxExponentBits, teethCount, combCount);
+		const size_t tableSize = size_t(1) << teeth;
+		ownedEntries.resize(entryCount());
+
+		// rowBases[i] = base^(2^(i * rowLength)) shifted by the current comb offset
+		std::vector<uint_array<N>> rowBases(teeth);
+		rowBases[0] = context.toMontgomery(base);
+		for (uint8_t i = 1; i < teeth; ++i) {
+			rowBases[i] = rowBases[i - 1];
+			for (uint16_t s = 0; s < rowLength; ++s) {
+				rowBases[i] = context.square(rowBases[i]);
+			}
+		}
+
+		for (uint16_t j = 0; j < combs; ++j) {
+			if (j != 0) {
+				for (auto& rowBase : rowBases) {
+					for (uint16_t s = 0; s < combSpacing; ++s) {
+						rowBase = context.square(rowBase);
+					}
+				}
+			}
+			uint_array<N>* comb = &ownedEntries[j * tableSize];
+			comb[0] = context.one();
+			for (size_t u = 1; u < tableSize; ++u) {
+				const size_t rest = u & (u - 1);	// u without its lowest set bit
+				const uint_array<N>& rowBase = rowBases[std::countr_zero(u)];
+				comb[u] = (rest == 0) ? rowBase : context.multiply(comb[rest], rowBase);
+			}
+		}
+	}
+
+	uint16_t maxExponentBits() const noexcept {
+		return exponentBits;
+	}
+
+	const MontgomeryContext<N>& montgomeryContext() const noexcept {
+		return context;
+	}
+
+	/// @brief Memory used by the table entries in bytes
+	size_t tableBytes() const noexcept {
+		return entryCount() * sizeof(uint_array<N>);
+	}
+
+	/// @brief base^exponent in Montgomery form. Throws std::out_of_range if the exponent is wider than maxExponentBits()
+	template <uint8_t M>
+	uint_array<N> powMontgomery(const uint_array<M>& exponent) const {
+		if (exponent.bitLength() > exponentBits) {
+			throw std::out_of_range("Exponent is wider than the precomputed table.");
+		}
+		const uint_array<N>* table = entries();
+		uint_array<N> result = context.one();
+		for (int16_t k = combSpacing - 1; k >= 0; --k) {
+			if (k != combSpacing - 1) {
+				result = context.square(result);
+			}
+			for (int16_t j = combs - 1; j >= 0; --j) {
+				const uint16_t column = j * combSpacing + k;
+				if (column >= rowLength) {
+					continue;	// Past the end of the last (shorter) block
+				}
+				size_t u = 0;
+				for (uint8_t i = 0; i < teeth; ++i) {
+					u |= static_cast<size_t>(extractBits(exponent, i * rowLength + column, 1)) << i;
+				}
+				if (u != 0) {
+					result = context.multiply(result, table[(static_cast<size_t>(j) << teeth) | u]);
+				}
+			}
+		}
+		return result;
+	}
+
+	/// @brief base^exponent mod m
+	template <uint8_t M>
+	uint_array<N> pow(const uint_array<M>& exponent) const {
+		return context.fromMontgomery(powMontgomery(exponent));
+	}
+
+	uint_array<N> pow(const uint64_t exponent) const {
+		return pow(uint_array<2>(exponent));
+	}
+
+	/// @brief Size of serialize() output in 64-bit words
+	size_t serializedWords() const noexcept {
+		return HEADER_WORDS + N + entryCount() * N;
+	}
+
+	/// @brief Writes the table as native-endian 64-bit words: header, modulus, then the entries.
+	/// The output can be memory mapped and opened with view() without copying
+	void serialize(std::ostream& os) const {
+		const std::vector<uint64_t> header = headerWords(context.modulus(), exponentBits, teeth, combs);
+		os.write(reinterpret_cast<const char*>(header.data()), header.size() * sizeof(uint64_t));
+		os.write(reinterpret_cast<const char*>(entries()), tableBytes());
+		if (!os) {
+			throw std::runtime_error("Failed to write fixed-base table.");
+		}
+	}
+
+	/// @brief Reads a table written by serialize() into owned memory
+	static FixedBaseTable deserialize(std::istream& is) {
+		std::vector<uint64_t> words(HEADER_WORDS + N);
+		is.read(reinterpret_cast<char*>(words.data()), words.size() * sizeof(uint64_t));
+		if (!is || words[0] != SERIAL_MAGIC || words[1] != N) {
+			throw std::invalid_argument("Stream does not contain a fixed-base table of this width.");
+		}
+		uint_array<N> modulus;
+		std::copy(words.begin() + HEADER_WORDS, words.end(), modulus.limbs().begin());
+
+		FixedBaseTable table(MontgomeryContext<N>{ modulus });
+		table.setLayout(static_cast<uint16_t>(words[2]), static_cast<uint8_t>(words[3]), static_cast<uint16_t>(words[4]));
+		table.ownedEntries.resize(table.entryCount());
+		is.read(reinterpret_cast<char*>(table.ownedEntries.data()), table.tableBytes());
+		if (!is) {
+			throw std::invalid_argument("Fixed-base table stream is truncated.");
+		}
+		return table;
+	}
+
+	/// @brief Opens a serialized table in place. The buffer must be 8-byte aligned and outlive the returned table
+	/// @param buffer Start of the serialized words, e.g. a memory mapped file
+	/// @param words Number of 64-bit words available in the buffer
+	static FixedBaseTable view(const uint64_t* buffer, const size_t words) {
+		if (words < HEADER_WORDS + N || buffer[0] != SERIAL_MAGIC || buffer[1] != N) {
+			throw std::invalid_argument("Buffer does not contain a fixed-base table of this width.");
+		}
+		uint_array<N> modulus;
+		std::copy(buffer + HEADER_WORDS, buffer + HEADER_WORDS + N, modulus.limbs().begin());
+
+		FixedBaseTable table(MontgomeryContext<N>{ modulus });
+		table.setLayout(static_cast<uint16_t>(buffer[2]), static_cast<uint8_t>(buffer[3]), static_cast<uint16_t>(buffer[4]));
+		if (words < table.serializedWords()) {
+			throw std::invalid_argument("Fixed-base table buffer is truncated.");
+		}
+		table.viewEntries = reinterpret_cast<const uint_array<N>*>(buffer + HEADER_WORDS + N);
+		return table;
+	}
+};
+
+
+/// @brief Number of terms from which multiExponentiate() switches from Straus to Pippenger
+constexpr size_t PIPPENGER_THRESHOLD = 32;
+
+template <uint8_t M>
+inline uint16_t maxSignificantBits(const uint_array<M>* exponents, const size_t count) noexcept {
+	uint16_t bits = 0;
+	for (size_t i = 0; i < count; ++i) {
+		bits = std::max(bits, exponents[i].bitLength());
+	}
+	return bits;
+}
+
+/// @brief Interleaved (Straus) product of powers prod(bases[i]^exponents[i]) mod m.
+/// One shared chain of squarings with a 2^w table per base - best for small counts
+template <uint8_t N, uint8_t M>
+uint_array<N> multiExponentiateStraus(const MontgomeryContext<N>& ctx, const uint_array<N>* bases,
+									  const uint_array<M>* exponents, const size_t count) {
+	const uint16_t bits = maxSignificantBits(exponents, count);
+	if (bits == 0) {
+		return ctx.fromMontgomery(ctx.one());
+	}
+	const uint8_t width = (bits > 128) ? 4 : (bits > 32) ? 3 : 2;
+	const size_t tableSize = size_t(1) << width;
+
+	ScratchArena& arena = ScratchArena::local();
+	ScratchArena::Frame frame(arena);
+	uint_array<N>* tables = arena.allocate<uint_array<N>>(count * tableSize);
+	for (size_t i = 0; i < count; ++i) {
+		uint_array<N>* table = &tables[i * tableSize];
+		table[0] = ctx.one();
+		table[1] = ctx.toMontgomery(bases[i]);
+		for (size_t d = 2; d < tableSize; ++d) {
+			table[d] = ctx.multiply(table[d - 1], table[1]);
+		}
+	}
+
+	const uint16_t topWindow = (bits - 1) / width;
+	uint_array<N> result = ctx.one();
+	for (int16_t w = topWindow; w >= 0; --w) {
+		if (w != topWindow) {
+			for (uint8_t s = 0; s < width; ++s) {
+				result = ctx.square(result);
+			}
+		}
+		for (size_t i = 0; i < count; ++i) {
+			const uint64_t digit = extractBits(exponents[i], w * width, width);
+			if (digit != 0) {
+				result = ctx.multiply(result, tables[i * tableSize + digit]);
+			}
+		}
+	}
+	return ctx.fromMontgomery(result);
+}
+
+/// @brief Bucketed (Pippenger) product of powers prod(bases[i]^exponents[i]) mod m.
+/// Each window sorts the bases into 2^c buckets by digit, so the per-term cost falls to about one multiplication per window
+template <uint8_t N, uint8_t M>
+uint_array<N> multiExponentiatePippenger(const MontgomeryContext<N>& ctx, const uint_array<N>* bases,
+										 const uint_array<M>* exponents, const size_t count) {
+	const uint16_t bits = maxSignificantBits(exponents, count);
+	if (bits == 0) {
+		return ctx.fromMontgomery(ctx.one());
+	}
+	const uint8_t width = static_cast<uint8_t>(std::clamp<int>(std::bit_width(count) - 2, 2, 12));
+	const size_t bucketCount = size_t(1) << width;
+
+	ScratchArena& arena = ScratchArena::local();
+	ScratchArena::Frame frame(arena);
+	uint_array<N>* montgomeryBases = arena.allocate<uint_array<N>>(count);
+	for (size_t i = 0; i < count; ++i) {
+		montgomeryBases[i] = ctx.toMontgomery(bases[i]);
+	}
+
+	uint_array<N>* buckets = arena.allocate<uint_array<N>>(bucketCount);
+	bool* used = arena.allocate<bool>(bucketCount);
+	const uint16_t topWindow = (bits - 1) / width;
+	uint_array<N> result = ctx.one();
+	for (int16_t w = topWindow; w >= 0; --w) {
+		if (w != topWindow) {
+			for (uint8_t s = 0; s < width; ++s) {
+				result = ctx.square(result);
+			}
+		}
+
+		std::fill(used, used + bucketCount, false);
+		for (size_t i = 0; i < count; ++i) {
+			const uint64_t digit = extractBits(exponents[i], w * width, width);
+			if (digit == 0) {
+				continue;
+			}
+			buckets[digit] = used[digit] ? ctx.multiply(buckets[digit], montgomeryBases[i]) : montgomeryBases[i];
+			used[digit] = true;
+		}
+
+		// prod(bucket[d]^d) = running products of the buckets from the top down, multiplied together
+		uint_array<N> running = ctx.one(), windowProduct = ctx.one();
+		bool runningUsed = false;
+		for (size_t d = bucketCount - 1; d > 0; --d) {
+			if (used[d]) {
+				running = runningUsed ? ctx.multiply(running, buckets[d]) : buckets[d];
+				runningUsed = true;
+			}
+			if (runningUsed) {
+				windowProduct = ctx.multiply(windowProduct, running);
+			}
+		}
+		result = ctx.multiply(result, windowProduct);
+	}
+	return ctx.fromMontgomery(result);
+}
+
+/// @brief prod(bases[i]^exponents[i]) mod m. Uses Straus below PIPPENGER_THRESHOLD terms and Pippenger above
+template <uint8_t N, uint8_t M>
+uint_array<N> multiExponentiate(const MontgomeryContext<N>& ctx, const uint_array<N>* bases,
+								const uint_array<M>* exponents, const size_t count) {
+	if (count < PIPPENGER_THRESHOLD) {
+		return multiExponentiateStraus(ctx, bases, exponents, count);
+	}
+	return multiExponentiatePippenger(ctx, bases, exponents, count);
+}
+
+template <uint8_t N, uint8_t M>
+uint_array<N> multiExponentiate(const MontgomeryContext<N>& ctx, const std::vector<uint_array<N>>& bases,
+								const std::vector<uint_array<M>>& exponents) {
+	if (bases.size() != exponents.size()) {
+		throw std::invalid_argument("Every base needs exactly one exponent.");
+	}
+	return multiExponentiate(ctx, bases.data(), exponents.data(), bases.size());
+}
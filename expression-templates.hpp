@@ -0,0 +1,134 @@
+// Author: Marek Oczadly
+// License: MIT
+// expression-templates.hpp
+
+#pragma once
+#include <cstdint>
+#include "utils.hpp"
+#include "largeInt.hpp"
+
+/*
+	Fused add/sub chains for uint_array.
+	uint_array<4> r = lazy(a) + b - c + d;
+	builds a small tree of references and evaluates it in a single pass over the limbs when assigned, with one signed carry
+	instead of a temporary per operator. The result width follows operator+/operator-: the widest operand (maxValue(N, M)).
+	Operands are held by reference, so an expression must not outlive the values it was built from.
+*/
+
+
+/// @brief Leaf of an expression - a reference to an existing value
+template <uint8_t N>
+class uint_array_ref {
+private:
+	const uint_array<N>& value;
+
+public:
+	static constexpr bool IS_UINT_ARRAY_EXPRESSION = true;
+	static constexpr uint8_t WIDTH = N;
+
+	explicit uint_array_ref(const uint_array<N>& v) noexcept : value(v) {}
+
+	/// @brief Adds (or subtracts when NEGATE) limb i into limb, counting wraparounds in carry
+	template <bool NEGATE>
+	inline void accumulate(const uint8_t i, uint64_t& limb, int64_t& carry) const noexcept {
+		if (i >= N) {
+			return;	// Narrower operands are zero extended
+		}
+		const uint64_t x = value.limbs()[i];
+		if constexpr (NEGATE) {
+			carry -= (limb < x) ? 1 : 0;
+			limb -= x;
+		}
+		else {
+			limb += x;
+			carry += (limb < x) ? 1 : 0;
+		}
+	}
+
+	template <uint8_t M>
+	void evaluateInto(uint_array<M>& dest) const noexcept {
+		dest = value;
+	}
+};
+
+
+/// @brief lhs + rhs, or lhs - rhs when SUBTRACT
+template <typename L, typename R, bool SUBTRACT>
+class uint_array_expr {
+private:
+	const L lhs;	// Nodes are copied (they only hold references), leaves keep referring to the operands
+	const R rhs;
+
+public:
+	static constexpr bool IS_UINT_ARRAY_EXPRESSION = true;
+	static constexpr uint8_t WIDTH = static_cast<uint8_t>(maxValue(L::WIDTH, R::WIDTH));
+
+	uint_array_expr(const L& l, const R& r) noexcept : lhs(l), rhs(r) {}
+
+	template <bool NEGATE>
+	inline void accumulate(const uint8_t i, uint64_t& limb, int64_t& carry) const noexcept {
+		lhs.template accumulate<NEGATE>(i, limb, carry);
+		rhs.template accumulate<NEGATE != SUBTRACT>(i, limb, carry);
+	}
+
+	/// @brief Writes the value into dest in one pass. Truncates or zero extends to dest's width like the converting constructor
+	template <uint8_t M>
+	void evaluateInto(uint_array<M>& dest) const noexcept {
+		constexpr uint8_t LIMBS = static_cast<uint8_t>(minValue(M, WIDTH));
+		auto& out = dest.limbs();
+		int64_t carry = 0;	// Signed - subtraction terms can make it negative
+		loopUnroll(LIMBS)
+			uint64_t limb = static_cast<uint64_t>(carry);
+			int64_t next = (carry < 0) ? -1 : 0;	// Sign extension of the incoming carry
+			this->template accumulate<false>(i, limb, next);
+			out[i] = limb;
+			carry = next;
+		endLoop
+		loopUnrollFrom(LIMBS, M)
+			out[i] = 0;
+		endLoop
+	}
+
+	uint_array<WIDTH> evaluate() const noexcept {
+		uint_array<WIDTH> result;
+		evaluateInto(result);
+		return result;
+	}
+};
+
+
+/// @brief Starts a fused expression
+template <uint8_t N>
+inline uint_array_ref<N> lazy(const uint_array<N>& value) noexcept {
+	return uint_array_ref<N>(value);
+}
+
+template <UintArrayExpression L, UintArrayExpression R>
+inline uint_array_expr<L, R, false> operator+(const L& lhs, const R& rhs) noexcept {
+	return uint_array_expr<L, R, false>(lhs, rhs);
+}
+
+template <UintArrayExpression L, UintArrayExpression R>
+inline uint_array_expr<L, R, true> operator-(const L& lhs, const R& rhs) noexcept {
+	return uint_array_expr<L, R, true>(lhs, rhs);
+}
+
+template <UintArrayExpression L, uint8_t M>
+inline uint_array_expr<L, uint_array_ref<M>, false> operator+(const L& lhs, const uint_array<M>& rhs) noexcept {
+	return uint_array_expr<L, uint_array_ref<M>, false>(lhs, uint_array_ref<M>(rhs));
+}
+
+template <UintArrayExpression L, uint8_t M>
+inline uint_array_expr<L, uint_array_ref<M>, true> operator-(const L& lhs, const uint_array<M>& rhs) noexcept {
+	return uint_array_expr<L, uint_array_ref<M>, true>(lhs, uint_array_ref<M>(rhs));
+}
+
+template <uint8_t N, UintArrayExpression R>
+inline uint_array_expr<uint_array_ref<N>, R, false> operator+(const uint_array<N>& lhs, const R& rhs) noexcept {
+	return uint_array_expr<uint_array_ref<N>, R, false>(uint_array_ref<N>(lhs), rhs);
+}
+
+template <uint8_t N, UintArrayExpression R>
+inline uint_array_expr<uint_array_ref<N>, R, true> operator-(const uint_array<N>& lhs, const R& rhs) noexcept {
+	return uint_array_expr<uint_array_ref<N>, R, true>(uint_array_ref<N>(lhs), rhs);
+}
@@ -4,8 +4,12 @@
 
 #pragma once
 #include <array>
+#include <compare>
 #include <iostream>
 #include <initializer_list>
+#include <span>
+#include <bit>
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <stdexcept>
@@ -14,6 +18,19 @@
 #include "bitwise-functions.hpp"
 
 
+/// @brief Define LARGE_INT_NORMALIZED_LENGTH to make +, - and multiplication skip high zero limbs (found with limbCount()).
+/// Worth it when values are usually far smaller than their type, costs a scan when they are not
+#if defined(LARGE_INT_NORMALIZED_LENGTH)
+inline constexpr bool NORMALIZED_LENGTH = true;
+#else
+inline constexpr bool NORMALIZED_LENGTH = false;
+#endif
+inline constexpr uint8_t NORMALIZED_MIN_LIMBS = 8;	// Below this + and - are cheaper than the scan
+
+/// @brief Lazy add/sub chains built by lazy() in expression-templates.hpp. Evaluated in one pass when assigned to a uint_array
+template <typename E>
+concept UintArrayExpression = requires { E::IS_UINT_ARRAY_EXPRESSION; };
+
 /// @brief A 256-bit unsigned integer class that can be used for large integer arithmetic
 template <uint8_t N>
 class uint_array {
@@ -29,49 +46,83 @@ private:
 
 	//static uint8_t inline 
 
+	/// @brief Limbs a kernel has to visit - the used limbs in normalized length mode, otherwise all of them
+	template <uint8_t M>
+	static uint8_t usedLimbs(const uint_array<M>& value) noexcept {
+		if constexpr (NORMALIZED_LENGTH) {
+			return value.limbCount();
+		}
+		else {
+			return M;
+		}
+	}
+
+	static void checkView(const uint8_t* bytes, const size_t size) {
+		static_assert(std::endian::native == std::endian::little, "In place views need the limbs to be little-endian in memory.");
+		static_assert(sizeof(uint_array<N>) == 8U * N && std::is_standard_layout_v<uint_array<N>>, "uint_array must be exactly its limbs.");
+		if (size < 8U * N) {
+			throw std::out_of_range("Buffer is smaller than the integer.");
+		}
+		if (reinterpret_cast<uintptr_t>(bytes) % alignof(uint64_t) != 0) {
+			throw std::invalid_argument("Buffer must be 8-byte aligned to be viewed in place.");
+		}
+	}
+
+	/// @brief Schoolbook product truncated to maxValue(N, M) limbs
 	template <uint8_t M>
 	inline uint_array<maxValue(N, M)> naiveMultiply(const uint_array<M>& other) const noexcept {
-		if constexpr (N == M) {
-			uint_array<N> result = 0;
-			uint64_t carry;
-			for (char i = 0; i < N; ++i) {
-				carry = 0;
-				for (char j = 0; j < N - i - 1; ++j) {
-					multiply64x64<true>(data[i], other.data[j], carry, result[i + j], result[i + j + 1]);
-				}
-				uint64_t temp;	// Dummy variable to fill an argument
-				multiply64x64<false>(data[i], other.data[N - i - 1], carry, result[N - 1], temp);
+		constexpr uint8_t R = maxValue(N, M);
+		uint_array<R> result(0);
+		const uint8_t usedA = usedLimbs(*this), usedB = usedLimbs(other);
+		for (uint8_t i = 0; i < usedA; ++i) {
+			uint64_t carry = 0;
+			const uint8_t end = static_cast<uint8_t>(minValue(usedB, R - i));
+			for (uint8_t j = 0; j < end; ++j) {
+				result.data[i + j] = multiplyAdd64(data[i], other.data[j], result.data[i + j], carry);
 			}
-			return result;
-		}
-		else if constexpr (N > M) {
-			uint_array<N> result = 0;
-			uint64_t carry;
-			for (char i = 0; i < M; ++i) {
-				carry = 0;
-				for (char j = 0; j < N - i - 1; ++j) {
-					multiply64x64<true>(other.data[j], data[i], carry, result[i + j], result[i + j + 1]);
-				}
-				uint64_t temp;	// Dummy variable to fill an argument
-				multiply64x64<false>(other.data[i], data[N - i - 1], carry, result[N - 1], temp);
+			if (i + end < R) {
+				result.data[i + end] = carry;
 			}
-			return result;
 		}
-		else {	// M > N
-			uint_array<M> result = 0;
-			uint64_t carry;
-			for (char i = 0; i < N; ++i) {
-				carry = 0;
-				for (char j = 0; j < M - i - 1; ++j) {
-					multiply64x64<true>(data[i], other.data[j], carry, result[i + j], result[i + j + 1]);
-				}
-				uint64_t temp;	// Dummy variable to fill an argument
-				multiply64x64<false>(data[i], other.data[M - i - 1], carry, result[M - 1], temp);
-			}
-			return result;
+		return result;
+	}
+
+	/// @brief a + b over the used limbs only. Limbs past the longer operand are just the final carry
+	template <uint8_t A, uint8_t B>
+	static void addNormalized(uint_array<maxValue(A, B)>& result, const uint_array<A>& a, const uint_array<B>& b) noexcept {
+		constexpr uint8_t R = maxValue(A, B);
+		const uint8_t usedA = a.limbCount(), usedB = b.limbCount();
+		const uint8_t common = static_cast<uint8_t>(minValue(usedA, usedB)), used = static_cast<uint8_t>(maxValue(usedA, usedB));
+		const uint64_t* longer = (usedA >= usedB) ? a.data.data() : b.data.data();
+		unsigned char carry = 0;
+		for (uint8_t i = 0; i < common; ++i) {
+			addWithOverflow(a.data[i], b.data[i], result.data[i], carry);
+		}
+		for (uint8_t i = common; i < used; ++i) {
+			result.data[i] = longer[i] + carry;
+			carry = (carry && result.data[i] == 0) ? 1 : 0;
+		}
+		if (used < R) {
+			result.data[used] = carry;
+			std::fill(result.data.begin() + used + 1, result.data.end(), 0);
 		}
 	}
 
+	/// @brief a - b over the used limbs only. Limbs past the longer operand are all ones if the result wrapped
+	template <uint8_t A, uint8_t B>
+	static void subtractNormalized(uint_array<maxValue(A, B)>& result, const uint_array<A>& a, const uint_array<B>& b) noexcept {
+		constexpr uint8_t R = maxValue(A, B);
+		const uint8_t usedA = a.limbCount(), usedB = b.limbCount();
+		const uint8_t used = static_cast<uint8_t>(maxValue(usedA, usedB));
+		unsigned char borrow = 0;
+		for (uint8_t i = 0; i < used; ++i) {
+			const uint64_t x = (i < A) ? a.data[i] : 0;
+			const uint64_t y = (i < B) ? b.data[i] : 0;
+			subtractWithBorrow(x, y, result.data[i], borrow);
+		}
+		std::fill(result.data.begin() + used, result.data.end(), borrow ? UINT64_MAX : 0);
+	}
+
 	// Base = 2^64
 	template <uint8_t M>
 	inline uint_array<maxValue(N, M)> karatsubaMultiply(const uint_array<M>& other) const noexcept {
@@ -145,9 +196,110 @@ public:
 
 	constexpr uint_array(const std::array<uint64_t, N> arr) : data(arr) {}
 
+	/// @brief Evaluates a fused add/sub chain straight into this value
+	template <UintArrayExpression E>
+	uint_array(const E& expr) noexcept {
+		expr.evaluateInto(*this);
+	}
+
 	inline constexpr char size() const noexcept {
 		return N;
 	}
+
+	/// @brief Unchecked access to the underlying words (least significant first). Used by the arithmetic kernels
+	inline const std::array<uint64_t, N>& limbs() const noexcept {
+		return data;
+	}
+
+	inline std::array<uint64_t, N>& limbs() noexcept {
+		return data;
+	}
+
+	/*
+		======================= BYTE IMPORT / EXPORT =======================
+		Fixed width encodings of exactly 8 * N bytes. LE is a memcpy of the limbs on little-endian hosts,
+		BE is the same bytes reversed (see reverseBytes).
+	*/
+
+	static constexpr size_t BYTE_SIZE = 8U * N;
+
+	/// @brief Writes 8 * N little-endian bytes. Throws std::out_of_range if out is shorter
+	void toBytesLE(const std::span<uint8_t> out) const {
+		if (out.size() < BYTE_SIZE) {
+			throw std::out_of_range("Output buffer is smaller than the integer.");
+		}
+		if constexpr (std::endian::native == std::endian::little) {
+			std::memcpy(out.data(), data.data(), BYTE_SIZE);
+		}
+		else {
+			for (size_t i = 0; i < BYTE_SIZE; ++i) {
+				out[i] = static_cast<uint8_t>(data[i / 8U] >> (8U * (i % 8U)));
+			}
+		}
+	}
+
+	/// @brief Writes 8 * N big-endian bytes. Throws std::out_of_range if out is shorter
+	void toBytesBE(const std::span<uint8_t> out) const {
+		if (out.size() < BYTE_SIZE) {
+			throw std::out_of_range("Output buffer is smaller than the integer.");
+		}
+		if constexpr (std::endian::native == std::endian::little) {
+			reverseBytes(out.data(), reinterpret_cast<const uint8_t*>(data.data()), BYTE_SIZE);
+		}
+		else {
+			for (size_t i = 0; i < BYTE_SIZE; ++i) {
+				out[BYTE_SIZE - 1 - i] = static_cast<uint8_t>(data[i / 8U] >> (8U * (i % 8U)));
+			}
+		}
+	}
+
+	/// @brief Reads up to 8 * N little-endian bytes. Shorter input is zero-extended, longer input throws std::out_of_range
+	static uint_array<N> fromBytesLE(const std::span<const uint8_t> bytes) {
+		if (bytes.size() > BYTE_SIZE) {
+			throw std::out_of_range("Input has more bytes than the integer.");
+		}
+		uint_array<N> result(0);
+		if constexpr (std::endian::native == std::endian::little) {
+			std::memcpy(result.data.data(), bytes.data(), bytes.size());
+		}
+		else {
+			for (size_t i = 0; i < bytes.size(); ++i) {
+				result.data[i / 8U] |= static_cast<uint64_t>(bytes[i]) << (8U * (i % 8U));
+			}
+		}
+		return result;
+	}
+
+	/// @brief Reads up to 8 * N big-endian bytes. Shorter input is zero-extended, longer input throws std::out_of_range
+	static uint_array<N> fromBytesBE(const std::span<const uint8_t> bytes) {
+		if (bytes.size() > BYTE_SIZE) {
+			throw std::out_of_range("Input has more bytes than the integer.");
+		}
+		uint_array<N> result(0);
+		if constexpr (std::endian::native == std::endian::little) {
+			reverseBytes(reinterpret_cast<uint8_t*>(result.data.data()), bytes.data(), bytes.size());
+		}
+		else {
+			for (size_t i = 0; i < bytes.size(); ++i) {
+				result.data[i / 8U] |= static_cast<uint64_t>(bytes[bytes.size() - 1 - i]) << (8U * (i % 8U));
+			}
+		}
+		return result;
+	}
+
+	/// @brief Uses a little-endian buffer as a uint_array in place, without copying. The buffer has to be 8-byte aligned
+	/// (throws std::invalid_argument) and at least 8 * N bytes (throws std::out_of_range). Little-endian hosts only
+	static const uint_array<N>& viewLE(const std::span<const uint8_t> bytes) {
+		checkView(bytes.data(), bytes.size());
+		return *reinterpret_cast<const uint_array<N>*>(bytes.data());
+	}
+
+	/// @brief Writable form of viewLE - changes to the value go straight to the buffer
+	static uint_array<N>& viewMutableLE(const std::span<uint8_t> bytes) {
+		checkView(bytes.data(), bytes.size());
+		return *reinterpret_cast<uint_array<N>*>(bytes.data());
+	}
+
 	const uint64_t& operator[](const char index) const {
 		if (index >= N || index < 0) {
 			throw std::out_of_range("Index out of range");
@@ -192,7 +344,12 @@ public:
 
 	template <uint8_t M>
 	uint_array<maxValue(N, M)> operator+(const uint_array<M>& other) const noexcept {
-		if constexpr (N == M) {
+		if constexpr (NORMALIZED_LENGTH && maxValue(N, M) >= NORMALIZED_MIN_LIMBS) {
+			uint_array<maxValue(N, M)> result;
+			addNormalized(result, *this, other);
+			return result;
+		}
+		else if constexpr (N == M) {
 			uint_array<N> result;
 			unsigned char carry = 0;
 			loopUnroll(N)
@@ -258,7 +415,12 @@ public:
 
 	template <uint8_t M>
 	uint_array<maxValue(M, N)> operator-(const uint_array<M>& other) const noexcept {
-		if constexpr (N == M) {
+		if constexpr (NORMALIZED_LENGTH && maxValue(N, M) >= NORMALIZED_MIN_LIMBS) {
+			uint_array<maxValue(N, M)> result;
+			subtractNormalized(result, *this, other);
+			return result;
+		}
+		else if constexpr (N == M) {
 			uint_array<N> result;
 			unsigned char borrow = 0;
 			loopUnroll(N)
@@ -378,6 +540,12 @@ public:
 		}
 	}
 
+	template <UintArrayExpression E>
+	uint_array<N>& operator=(const E& expr) noexcept {
+		expr.evaluateInto(*this);	// Safe when this value is also an operand - limb i is read before it is written
+		return *this;
+	}
+
 	uint_array<N>& operator=(const uint64_t other) noexcept {
 		data.fill(0);
 		data[0] = other;
@@ -407,6 +575,12 @@ public:
 		}
 	}
 
+	/// @brief Product truncated to the wider operand
+	template <uint8_t M>
+	uint_array<maxValue(N, M)> operator*(const uint_array<M>& other) const noexcept {
+		return naiveMultiply(other);
+	}
+
 	template <uint8_t M>
 	bool operator==(const uint_array<M>& other) const noexcept {
 		if constexpr (N == M) {
@@ -432,20 +606,233 @@ public:
 		}
 	}
 
-	template <char M>
+	template <uint8_t M>
 	bool operator !=(const uint_array<M>& other) const noexcept {
 		return not(this->operator==(other));
 	}
 
-	uint_array<N> operator<<(const uint16_t places) {
-		return leftShift(data, places);
+	/// @brief Ordering across mixed widths. Scans from the most significant limb and returns at the first difference
+	template <uint8_t M>
+	std::strong_ordering operator<=>(const uint_array<M>& other) const noexcept {
+		if constexpr (N > M) {
+			for (uint8_t i = N - 1; i >= M; --i) {
+				if (data[i] != 0) {
+					return std::strong_ordering::greater;
+				}
+			}
+		}
+		else if constexpr (M > N) {
+			for (uint8_t i = M - 1; i >= N; --i) {
+				if (other.data[i] != 0) {
+					return std::strong_ordering::less;
+				}
+			}
+		}
+		return compareLimbs<minValue(N, M)>(data.data(), other.data.data()) <=> 0;
+	}
+
+	/// @brief Constant-time three-way comparison for secret values. Reads every limb and never branches on the data.
+	/// Returns -1, 0 or 1
+	template <uint8_t M>
+	int ctCompare(const uint_array<M>& other) const noexcept {
+		int64_t result = 0;
+		for (uint8_t i = 0; i < maxValue(N, M); ++i) {	// Bottom up so the most significant difference is written last
+			const uint64_t a = (i < N) ? data[i] : 0;	// The bounds are compile-time, not secret
+			const uint64_t b = (i < M) ? other.data[i] : 0;
+			const uint64_t diff = a - b;
+			const uint64_t less = ((~a & b) | (~(a ^ b) & diff)) >> 63;	// Borrow out of a - b
+			const uint64_t greater = ((~b & a) | (~(a ^ b) & (b - a))) >> 63;
+			const int64_t differ = -static_cast<int64_t>(less | greater);
+			result = (result & ~differ) | ((static_cast<int64_t>(greater) - static_cast<int64_t>(less)) & differ);
+		}
+		return static_cast<int>(result);
+	}
+
+	/// @brief Limbs up to and including the highest non-zero one (0 for zero). Kernels can stop here instead of at N
+	uint8_t limbCount() const noexcept {
+		uint8_t i = N;
+#if defined(__AVX512F__)
+		if constexpr (N >= 8) {
+			for (; i >= 8; i -= 8) {
+				const __m512i block = _mm512_loadu_si512(data.data() + i - 8);
+				const uint32_t nonZero = _mm512_test_epi64_mask(block, block);
+				if (nonZero != 0) {
+					return static_cast<uint8_t>(i - 8 + 32 - std::countl_zero(nonZero));
+				}
+			}
+		}
+#endif
+		for (; i > 0; --i) {
+			if (data[i - 1] != 0) {
+				return i;
+			}
+		}
+		return 0;
+	}
+
+	/// @brief Bits needed to represent the value (0 for zero)
+	uint16_t bitLength() const noexcept {
+		const uint8_t limbs = limbCount();
+		return (limbs == 0) ? 0 : static_cast<uint16_t>(64U * limbs - countLeadingZeros64(data[limbs - 1]));
+	}
+
+	/// @brief Leading zero bits across all 64 * N bits (64 * N for zero)
+	uint16_t countLeadingZeros() const noexcept {
+		return static_cast<uint16_t>(64U * N - bitLength());
 	}
 
-	uint_array<N>& operator<<=(const uint16_t places) {
-		leftShiftInPlace(data, places);
+	/// @brief Trailing zero bits (64 * N for zero)
+	uint16_t countTrailingZeros() const noexcept {
+		for (uint8_t i = 0; i < N; ++i) {
+			if (data[i] != 0) {
+				return static_cast<uint16_t>(64U * i + countTrailingZeros64(data[i]));
+			}
+		}
+		return 64U * N;
+	}
+
+	uint16_t popcount() const noexcept {
+		uint16_t count = 0;
+		uint8_t i = 0;
+#if defined(__AVX512VPOPCNTDQ__)
+		if constexpr (N >= 8) {
+			__m512i counts = _mm512_setzero_si512();
+			for (; i + 8 <= N; i += 8) {
+				counts = _mm512_add_epi64(counts, _mm512_popcnt_epi64(_mm512_loadu_si512(data.data() + i)));
+			}
+			count = static_cast<uint16_t>(_mm512_reduce_add_epi64(counts));
+		}
+#endif
+		for (; i < N; ++i) {
+			count += popcount64(data[i]);
+		}
+		return count;
+	}
+
+	uint_array<N> operator<<(const uint16_t places) const noexcept {
+		uint_array<N> result;
+		shiftLimbsLeft(result.data, data, places);
+		return result;
+	}
+
+	uint_array<N>& operator<<=(const uint16_t places) noexcept {
+		shiftLimbsLeft(data, data, places);
+		return *this;
+	}
+
+	uint_array<N> operator>>(const uint16_t places) const noexcept {
+		uint_array<N> result;
+		shiftLimbsRight(result.data, data, places);
+		return result;
+	}
+
+	uint_array<N>& operator>>=(const uint16_t places) noexcept {
+		shiftLimbsRight(data, data, places);
 		return *this;
 	}
 
+	/// @brief Rotates through all 64 * N bits. places is taken modulo the width
+	uint_array<N> rotateLeft(uint16_t places) const noexcept {
+		places %= 64U * N;
+		if (places == 0) {
+			return *this;
+		}
+		uint_array<N> high, low;
+		shiftLimbsLeft(high.data, data, places);
+		shiftLimbsRight(low.data, data, 64U * N - places);
+		return high | low;
+	}
+
+	uint_array<N> rotateRight(uint16_t places) const noexcept {
+		places %= 64U * N;
+		return rotateLeft(places == 0 ? 0 : 64U * N - places);
+	}
+
+	template <uint8_t M>
+	uint_array<maxValue(N, M)> operator&(const uint_array<M>& other) const noexcept {
+		uint_array<maxValue(N, M)> result(0);
+		loopUnroll(minValue(N, M))
+			result.data[i] = data[i] & other.data[i];
+		endLoop
+		return result;
+	}
+
+	template <uint8_t M>
+	uint_array<maxValue(N, M)> operator|(const uint_array<M>& other) const noexcept {
+		uint_array<maxValue(N, M)> result;
+		loopUnroll(minValue(N, M))
+			result.data[i] = data[i] | other.data[i];
+		endLoop
+		if constexpr (N > M) {
+			loopUnrollFrom(M, N)
+				result.data[i] = data[i];
+			endLoop
+		}
+		else if constexpr (M > N) {
+			loopUnrollFrom(N, M)
+				result.data[i] = other.data[i];
+			endLoop
+		}
+		return result;
+	}
+
+	template <uint8_t M>
+	uint_array<maxValue(N, M)> operator^(const uint_array<M>& other) const noexcept {
+		uint_array<maxValue(N, M)> result;
+		loopUnroll(minValue(N, M))
+			result.data[i] = data[i] ^ other.data[i];
+		endLoop
+		if constexpr (N > M) {
+			loopUnrollFrom(M, N)
+				result.data[i] = data[i];
+			endLoop
+		}
+		else if constexpr (M > N) {
+			loopUnrollFrom(N, M)
+				result.data[i] = other.data[i];
+			endLoop
+		}
+		return result;
+	}
+
+	/// @brief The compound forms keep width N. A narrower other is zero-extended and limbs of a wider one are ignored
+	template <uint8_t M>
+	uint_array<N>& operator&=(const uint_array<M>& other) noexcept {
+		loopUnroll(minValue(N, M))
+			data[i] &= other.data[i];
+		endLoop
+		if constexpr (N > M) {
+			loopUnrollFrom(M, N)
+				data[i] = 0;
+			endLoop
+		}
+		return *this;
+	}
+
+	template <uint8_t M>
+	uint_array<N>& operator|=(const uint_array<M>& other) noexcept {
+		loopUnroll(minValue(N, M))
+			data[i] |= other.data[i];
+		endLoop
+		return *this;
+	}
+
+	template <uint8_t M>
+	uint_array<N>& operator^=(const uint_array<M>& other) noexcept {
+		loopUnroll(minValue(N, M))
+			data[i] ^= other.data[i];
+		endLoop
+		return *this;
+	}
+
+	uint_array<N> operator~() const noexcept {
+		uint_array<N> result;
+		loopUnroll(N)
+			result.data[i] = ~data[i];
+		endLoop
+		return result;
+	}
+
 	std::wstring toWString() const noexcept {
 		constexpr auto numBytes = UINT64_BCD_ARRAY_SIZE(N) * 8;
 		auto bcdArray = BCD();
@@ -12,6 +12,7 @@ Compilation information:
 
 
 #include "largeInt.hpp"
+#include "benchmarks.hpp"
 #include <iostream>
 #include <bitset>
 
@@ -19,9 +20,7 @@ int main() {
 	/*uint256_t a = 12345678901234567899ULL;*/
 
 	/*std::cout << "a: " << a.toString() << NEWL;*/
-	loopBackwardsFrom(256, 10)
-		std::cout << (int)i << ' ';
-	endLoop
+	runBenchmarks(std::cout);
 	std::cout << std::endl;
 
 	return 0;
@@ -4,6 +4,7 @@
 
 #pragma once
 #include <cstdint>
+#include <bit>
 
 #if defined(_MSC_VER)
 #include <intrin.h>
@@ -103,4 +104,87 @@ inline void multiply64x64(const uint64_t a, const uint64_t b, uint8_t& carry, ui
 #else
 	// TODO: Implement manual implemtation 
 #endif
-}
\ No newline at end of file
+}
+
+/// @brief Computes a * b + addend + carry as a 128-bit value. Cannot overflow as (2^64 - 1)^2 + 2 * (2^64 - 1) < 2^128
+/// @param a First factor
+/// @param b Second factor
+/// @param addend Value added to the product
+/// @param carry Value added to the product. Holds the high 64 bits of the result afterwards
+/// @return The low 64 bits of the result
+inline uint64_t multiplyAdd64(const uint64_t a, const uint64_t b, const uint64_t addend, uint64_t& carry) noexcept {
+#if defined(_MSC_VER) && defined(_M_X64)
+	uint64_t high, low = _umul128(a, b, &high);
+	unsigned char c = _addcarry_u64(0, low, addend, &low);
+	_addcarry_u64(c, high, 0, &high);
+	c = _addcarry_u64(0, low, carry, &low);
+	_addcarry_u64(c, high, 0, &high);
+	carry = high;
+	return low;
+#elif defined(__SIZEOF_INT128__)	// Available on G++ and Clang
+	const __uint128_t result = static_cast<__uint128_t>(a) * b + addend + carry;
+	carry = static_cast<uint64_t>(result >> 64);
+	return static_cast<uint64_t>(result);
+#else	// Manual arithmetic using 32-bit halves
+	const uint64_t aLow = a & 0xFFFFFFFFULL, aHigh = a >> 32;
+	const uint64_t bLow = b & 0xFFFFFFFFULL, bHigh = b >> 32;
+	const uint64_t ll = aLow * bLow, lh = aLow * bHigh, hl = aHigh * bLow, hh = aHigh * bHigh;
+	const uint64_t middle = (ll >> 32) + (lh & 0xFFFFFFFFULL) + (hl & 0xFFFFFFFFULL);
+	uint64_t low = (middle << 32) | (ll & 0xFFFFFFFFULL);
+	uint64_t high = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+	low += addend;
+	high += (low < addend) ? 1 : 0;
+	low += carry;
+	high += (low < carry) ? 1 : 0;
+	carry = high;
+	return low;
+#endif
+}
+
+/// @brief Leading zero bits of a word, 64 for 0. lzcnt where the target has it
+inline uint8_t countLeadingZeros64(const uint64_t value) noexcept {
+#if defined(_MSC_VER) && defined(__AVX2__)	// Every AVX2 CPU has lzcnt
+	return static_cast<uint8_t>(__lzcnt64(value));
+#elif defined(_MSC_VER)
+	unsigned long index;
+	return _BitScanReverse64(&index, value) ? static_cast<uint8_t>(63 - index) : 64;
+#else	// G++/Clang emit lzcnt with -mlzcnt (or -march), bsr otherwise
+	return static_cast<uint8_t>(std::countl_zero(value));
+#endif
+}
+
+/// @brief Trailing zero bits of a word, 64 for 0. tzcnt where the target has it
+inline uint8_t countTrailingZeros64(const uint64_t value) noexcept {
+#if defined(_MSC_VER) && defined(__AVX2__)	// Every AVX2 CPU has BMI1
+	return static_cast<uint8_t>(_tzcnt_u64(value));
+#elif defined(_MSC_VER)
+	unsigned long index;
+	return _BitScanForward64(&index, value) ? static_cast<uint8_t>(index) : 64;
+#else
+	return static_cast<uint8_t>(std::countr_zero(value));
+#endif
+}
+
+/// @brief Set bits in a word. popcnt where the target has it
+inline uint8_t popcount64(const uint64_t value) noexcept {
+#if defined(_MSC_VER) && defined(__AVX__)	// Every AVX CPU has popcnt
+	return static_cast<uint8_t>(__popcnt64(value));
+#else
+	return static_cast<uint8_t>(std::popcount(value));
+#endif
+}
+
+/// @brief Reverses the bytes of a word (bswap)
+inline uint64_t byteSwap64(const uint64_t value) noexcept {
+#if defined(_MSC_VER)
+	return _byteswap_uint64(value);
+#elif defined(__GNUC__) || defined(__clang__)
+	return __builtin_bswap64(value);
+#else
+	uint64_t result = 0;
+	for (uint8_t i = 0; i < 8; ++i) {
+		result = (result << 8) | ((value >> (8 * i)) & 0xFFU);
+	}
+	return result;
+#endif
+}
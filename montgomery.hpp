@@ -0,0 +1,197 @@
+// Author: Marek Oczadly
+// License: MIT
+// montgomery.hpp
+
+#pragma once
+#include <cstdint>
+#include <array>
+#include <stdexcept>
+#include "utils.hpp"
+#include "math-intrinsics.hpp"
+#include "largeInt.hpp"
+#include "scratch-arena.hpp"
+
+
+/// @brief Reads up to 64 bits starting at bit index start. Bits past the end of the value read as 0
+template <uint8_t M>
+inline uint64_t extractBits(const uint_array<M>& value, const uint16_t start, const uint8_t width) noexcept {
+	const auto& limbs = value.limbs();
+	const uint16_t wordIdx = start / 64U;
+	const uint8_t bitIdx = start % 64U;
+	if (wordIdx >= M) {
+		return 0;
+	}
+	uint64_t bits = limbs[wordIdx] >> bitIdx;
+	if (bitIdx != 0 && bitIdx + width > 64U && wordIdx + 1 < M) {
+		bits |= limbs[wordIdx + 1] << (64U - bitIdx);
+	}
+	return (width >= 64U) ? bits : (bits & ((1ULL << width) - 1ULL));
+}
+
+
+/// @brief Precomputed constants for Montgomery multiplication modulo an odd N-word modulus
+/// R = 2^(64 * N). Values in Montgomery form are stored as x * R mod m
+template <uint8_t N>
+class MontgomeryContext {
+private:
+	uint_array<N> modulusValue;
+	uint_array<N> montgomeryOne;	// R mod m
+	uint_array<N> rSquared;			// R^2 mod m
+	uint64_t negativeInverse;		// -m^-1 mod 2^64
+
+	/// @brief a >= b over N words
+	static bool greaterOrEqual(const std::array<uint64_t, N>& a, const std::array<uint64_t, N>& b) noexcept {
+		return compareLimbs<N>(a.data(), b.data()) >= 0;
+	}
+
+	static void subtractInPlace(std::array<uint64_t, N>& a, const std::array<uint64_t, N>& b) noexcept {
+		unsigned char borrow = 0;
+		loopUnroll(N)
+			subtractWithBorrow(a[i], b[i], borrow);
+		endLoop
+	}
+
+	/// @brief x = 2x mod m for x < m
+	void doubleModulo(uint_array<N>& x) const noexcept {
+		auto& limbs = x.limbs();
+		const uint64_t overflow = limbs[N - 1] >> 63;
+		for (int16_t i = N - 1; i > 0; --i) {
+			limbs[i] = (limbs[i] << 1) | (limbs[i - 1] >> 63);
+		}
+		limbs[0] <<= 1;
+		if (overflow || greaterOrEqual(limbs, modulusValue.limbs())) {
+			subtractInPlace(limbs, modulusValue.limbs());
+		}
+	}
+
+	/// @brief Window width for a left-to-right fixed window exponentiation
+	static constexpr uint8_t windowWidth(const uint16_t exponentBits) noexcept {
+		return (exponentBits > 239) ? 5 : (exponentBits > 79) ? 4 : (exponentBits > 23) ? 3 : 1;
+	}
+
+public:
+	/// @brief Builds the context. Throws std::invalid_argument if the modulus is even
+	explicit MontgomeryContext(const uint_array<N>& modulus) : modulusValue(modulus) {
+		const uint64_t m0 = modulus.limbs()[0];
+		if ((m0 & 1U) == 0) {
+			throw std::invalid_argument("Montgomery modulus must be odd.");
+		}
+
+		// Newton iteration - each step doubles the number of correct low bits (3 -> 6 -> ... -> 96)
+		uint64_t inverse = m0;
+		for (uint8_t i = 0; i < 5; ++i) {
+			inverse *= 2U - m0 * inverse;
+		}
+		negativeInverse = negate_uint64(inverse);
+
+		// R mod m and R^2 mod m by repeated doubling - avoids needing a general division
+		montgomeryOne = (modulus == uint_array<N>(1)) ? uint_array<N>(0) : uint_array<N>(1);
+		for (uint16_t i = 0; i < 64U * N; ++i) {
+			doubleModulo(montgomeryOne);
+		}
+		rSquared = montgomeryOne;
+		for (uint16_t i = 0; i < 64U * N; ++i) {
+			doubleModulo(rSquared);
+		}
+	}
+
+	const uint_array<N>& modulus() const noexcept {
+		return modulusValue;
+	}
+
+	/// @brief 1 in Montgomery form (R mod m)
+	const uint_array<N>& one() const noexcept {
+		return montgomeryOne;
+	}
+
+	/// @brief Montgomery product a * b * R^-1 mod m (CIOS). Requires a * b < m * R
+	uint_array<N> multiply(const uint_array<N>& a, const uint_array<N>& b) const noexcept {
+		const auto& x = a.limbs();
+		const auto& y = b.limbs();
+		const auto& m = modulusValue.limbs();
+		std::array<uint64_t, N + 2> t = { 0 };
+
+		for (uint8_t i = 0; i < N; ++i) {
+			uint64_t carry = 0;
+			for (uint8_t j = 0; j < N; ++j) {
+				t[j] = multiplyAdd64(x[j], y[i], t[j], carry);
+			}
+			unsigned char c = 0;
+			addWithOverflow(t[N], carry, c);
+			t[N + 1] = c;
+
+			const uint64_t u = t[0] * negativeInverse;
+			carry = 0;
+			multiplyAdd64(u, m[0], t[0], carry);	// Low word is 0 by construction of u
+			for (uint8_t j = 1; j < N; ++j) {
+				t[j - 1] = multiplyAdd64(u, m[j], t[j], carry);
+			}
+			c = 0;
+			addWithOverflow(t[N], carry, t[N - 1], c);
+			t[N] = t[N + 1] + c;
+		}
+
+		uint_array<N> result;
+		auto& r = result.limbs();
+		loopUnroll(N)
+			r[i] = t[i];
+		endLoop
+		if (t[N] != 0 || greaterOrEqual(r, m)) {
+			subtractInPlace(r, m);
+		}
+		return result;
+	}
+
+	uint_array<N> square(const uint_array<N>& a) const noexcept {
+		return multiply(a, a);
+	}
+
+	/// @brief Converts any N-word value into Montgomery form (reduces modulo m)
+	uint_array<N> toMontgomery(const uint_array<N>& a) const noexcept {
+		return multiply(a, rSquared);
+	}
+
+	uint_array<N> fromMontgomery(const uint_array<N>& a) const noexcept {
+		return multiply(a, uint_array<N>(1));
+	}
+
+	/// @brief base^exponent with base and result in Montgomery form. The window table lives in the thread's ScratchArena
+	template <uint8_t M>
+	uint_array<N> powMontgomery(const uint_array<N>& base, const uint_array<M>& exponent) const {
+		const uint16_t bits = exponent.bitLength();
+		if (bits == 0) {
+			return montgomeryOne;
+		}
+		const uint8_t width = windowWidth(bits);
+		ScratchArena::Frame frame(ScratchArena::local());
+		uint_array<N>* table = ScratchArena::local().allocate<uint_array<N>>(size_t(1) << width);
+		table[0] = montgomeryOne;
+		table[1] = base;
+		for (uint8_t i = 2; i < (1U << width); ++i) {
+			table[i] = multiply(table[i - 1], base);
+		}
+
+		const uint16_t topWindow = (bits - 1) / width;
+		uint_array<N> result = table[extractBits(exponent, topWindow * width, width)];
+		for (int16_t w = topWindow - 1; w >= 0; --w) {
+			for (uint8_t s = 0; s < width; ++s) {
+				result = square(result);
+			}
+			const uint64_t digit = extractBits(exponent, w * width, width);
+			if (digit != 0) {
+				result = multiply(result, table[digit]);
+			}
+		}
+		return result;
+	}
+
+	/// @brief base^exponent mod m
+	template <uint8_t M>
+	uint_array<N> modPow(const uint_array<N>& base, const uint_array<M>& exponent) const {
+		return fromMontgomery(powMontgomery(toMontgomery(base), exponent));
+	}
+
+	uint_array<N> modPow(const uint_array<N>& base, const uint64_t exponent) const {
+		return modPow(base, uint_array<2>(exponent));
+	}
+};
@@ -0,0 +1,339 @@
+// Author: Marek Oczadly
+// License: MIT
+// parallel-executor.hpp
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include "largeInt.hpp"
+#include "montgomery.hpp"
+
+#if defined(__linux__)
+#	include <pthread.h>
+#	include <sched.h>
+#elif defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#endif
+
+
+/// @brief Logical CPUs grouped by NUMA node. Falls back to a single node holding every CPU
+inline std::vector<std::vector<uint32_t>> detectNumaNodes() {
+	std::vector<std::vector<uint32_t>> nodes;
+#if defined(__linux__)
+	for (uint32_t node = 0; node < 1024; ++node) {
+		std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+		if (!file) {
+			break;
+		}
+		std::string list;
+		std::getline(file, list);
+		std::vector<uint32_t> cpus;
+		size_t pos = 0;
+		while (pos < list.size()) {	// Format: "0-3,8-11"
+			size_t end = list.find(',', pos);
+			if (end == std::string::npos) {
+				end = list.size();
+			}
+			const std::string range = list.substr(pos, end - pos);
+			const size_t dash = range.find('-');
+			if (!range.empty()) {
+				const uint32_t first = static_cast<uint32_t>(std::stoul(range.substr(0, dash)));
+				const uint32_t last = (dash == std::string::npos) ? first : static_cast<uint32_t>(std::stoul(range.substr(dash + 1)));
+				for (uint32_t cpu = first; cpu <= last; ++cpu) {
+					cpus.push_back(cpu);
+				}
+			}
+			pos = end + 1;
+		}
+		if (!cpus.empty()) {
+			nodes.push_back(std::move(cpus));
+		}
+	}
+#elif defined(_WIN32)
+	ULONG highestNode = 0;
+	if (GetNumaHighestNodeNumber(&highestNode)) {
+		for (UCHAR node = 0; node <= highestNode; ++node) {
+			ULONGLONG mask = 0;
+			if (!GetNumaNodeProcessorMask(node, &mask) || mask == 0) {
+				continue;
+			}
+			std::vector<uint32_t> cpus;
+			for (uint32_t cpu = 0; cpu < 64; ++cpu) {
+				if ((mask >> cpu) & 1ULL) {
+					cpus.push_back(cpu);
+				}
+			}
+			nodes.push_back(std::move(cpus));
+		}
+	}
+#endif
+	if (nodes.empty()) {
+		const uint32_t count = std::max(1U, std::thread::hardware_concurrency());
+		nodes.emplace_back();
+		for (uint32_t cpu = 0; cpu < count; ++cpu) {
+			nodes[0].push_back(cpu);
+		}
+	}
+	return nodes;
+}
+
+
+/// @brief Work-stealing thread pool for batches of independent big-integer jobs (modPow, signature checks, prime trials).
+/// Workers are spread across NUMA nodes and optionally pinned to a core. Each worker owns a deque - it pops its newest
+/// task and idle workers steal the oldest task of another worker, preferring workers on the same node.
+class ParallelExecutor {
+private:
+	struct Worker {
+		std::deque<std::function<void()>> tasks;
+		std::mutex lock;
+		uint32_t node = 0;
+		uint32_t cpu = 0;
+		std::vector<size_t> victims;	// Steal order: same node first, then the rest
+	};
+
+	static constexpr size_t CONTEXT_CACHE_SIZE = 8;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+	std::mutex sleepLock;
+	std::condition_variable wake;
+	std::atomic<size_t> queued{ 0 };
+	std::atomic<size_t> nextWorker{ 0 };
+	bool stopping = false;	// Guarded by sleepLock
+
+	static inline thread_local ParallelExecutor* currentExecutor = nullptr;
+	static inline thread_local size_t currentWorker = 0;
+
+	static void pinCurrentThread(const uint32_t cpu) noexcept {
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+		if (cpu < 64) {
+			SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+		}
+#else
+		(void)cpu;	// No affinity API (e.g. macOS) - leave scheduling to the OS
+#endif
+	}
+
+	bool popLocal(const size_t id, std::function<void()>& task) {
+		Worker& worker = *workers[id];
+		std::lock_guard<std::mutex> guard(worker.lock);
+		if (worker.tasks.empty()) {
+			return false;
+		}
+		task = std::move(worker.tasks.back());
+		worker.tasks.pop_back();
+		--queued;
+		return true;
+	}
+
+	bool steal(const size_t victim, std::function<void()>& task) {
+		Worker& worker = *workers[victim];
+		std::lock_guard<std::mutex> guard(worker.lock);
+		if (worker.tasks.empty()) {
+			return false;
+		}
+		task = std::move(worker.tasks.front());
+		worker.tasks.pop_front();
+		--queued;
+		return true;
+	}
+
+	bool findTask(const size_t id, std::function<void()>& task) {
+		if (popLocal(id, task)) {
+			return true;
+		}
+		for (const size_t victim : workers[id]->victims) {
+			if (steal(victim, task)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void run(const size_t id, const bool pin) {
+		currentExecutor = this;
+		currentWorker = id;
+		if (pin) {
+			pinCurrentThread(workers[id]->cpu);
+		}
+		std::function<void()> task;
+		while (true) {
+			if (findTask(id, task)) {
+				task();
+				continue;
+			}
+			std::unique_lock<std::mutex> guard(sleepLock);
+			wake.wait(guard, [this] { return stopping || queued.load() > 0; });
+			if (stopping && queued.load() == 0) {
+				return;
+			}
+		}
+	}
+
+	void push(std::function<void()> task) {
+		// Tasks submitted from a worker stay on that worker so nested batches keep their cache locality
+		const size_t id = (currentExecutor == this) ? currentWorker : nextWorker++ % workers.size();
+		{
+			std::lock_guard<std::mutex> guard(workers[id]->lock);
+			workers[id]->tasks.push_back(std::move(task));
+			++queued;
+		}
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+		}
+		wake.notify_one();
+	}
+
+public:
+	/// @param threadCount Number of workers. 0 uses one per logical CPU
+	/// @param pinToCores Pin each worker to one CPU, spreading workers evenly across NUMA nodes
+	explicit ParallelExecutor(size_t threadCount = 0, const bool pinToCores = true) {
+		const std::vector<std::vector<uint32_t>> nodes = detectNumaNodes();
+		if (threadCount == 0) {
+			threadCount = std::max(1U, std::thread::hardware_concurrency());
+		}
+
+		for (size_t i = 0; i < threadCount; ++i) {
+			auto worker = std::make_unique<Worker>();
+			worker->node = static_cast<uint32_t>(i % nodes.size());
+			const auto& cpus = nodes[worker->node];
+			worker->cpu = cpus[(i / nodes.size()) % cpus.size()];
+			workers.push_back(std::move(worker));
+		}
+		for (size_t i = 0; i < threadCount; ++i) {
+			for (size_t pass = 0; pass < 2; ++pass) {
+				for (size_t offset = 1; offset < threadCount; ++offset) {
+					const size_t victim = (i + offset) % threadCount;
+					if ((workers[victim]->node == workers[i]->node) == (pass == 0)) {
+						workers[i]->victims.push_back(victim);
+					}
+				}
+			}
+		}
+		for (size_t i = 0; i < threadCount; ++i) {
+			threads.emplace_back(&ParallelExecutor::run, this, i, pinToCores);
+		}
+	}
+
+	ParallelExecutor(const ParallelExecutor&) = delete;
+	ParallelExecutor& operator=(const ParallelExecutor&) = delete;
+
+	/// @brief Finishes every queued task, then joins the workers
+	~ParallelExecutor() {
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	size_t size() const noexcept {
+		return workers.size();
+	}
+
+	/// @brief Queues a job and returns a future for its result
+	template <typename F>
+	auto submit(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+		using R = std::invoke_result_t<std::decay_t<F>>;
+		auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+		std::future<R> result = task->get_future();
+		push([task]() { (*task)(); });
+		return result;
+	}
+
+	/// @brief Waits for a future. When called on a worker it runs other queued tasks while waiting instead of blocking
+	template <typename R>
+	R await(std::future<R>& future) {
+		if (currentExecutor == this) {
+			std::function<void()> task;
+			while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				if (findTask(currentWorker, task)) {
+					task();
+				}
+				else {
+					std::this_thread::yield();
+				}
+			}
+		}
+		return future.get();
+	}
+
+	/// @brief Runs func(i) for every i in [0, count), split into a few chunks per worker, and waits for all of them
+	template <typename F>
+	void parallelFor(const size_t count, F&& func) {
+		if (count == 0) {
+			return;
+		}
+		const size_t chunks = std::min(count, workers.size() * 4);
+		const size_t chunkSize = (count + chunks - 1) / chunks;
+		std::vector<std::future<void>> futures;
+		for (size_t start = 0; start < count; start += chunkSize) {
+			const size_t end = std::min(count, start + chunkSize);
+			futures.push_back(submit([&func, start, end]() {
+				for (size_t i = start; i < end; ++i) {
+					func(i);
+				}
+			}));
+		}
+		for (auto& future : futures) {
+			await(future);
+		}
+	}
+
+	/// @brief Montgomery context for a modulus, cached per worker thread so a batch pays for the precomputation once per core.
+	/// The reference stays valid until CONTEXT_CACHE_SIZE other moduli have been requested on the same thread
+	template <uint8_t N>
+	static const MontgomeryContext<N>& montgomeryContext(const uint_array<N>& modulus) {
+		static thread_local std::deque<MontgomeryContext<N>> cache;
+		for (const auto& ctx : cache) {
+			if (ctx.modulus() == modulus) {
+				return ctx;
+			}
+		}
+		if (cache.size() == CONTEXT_CACHE_SIZE) {
+			cache.pop_front();
+		}
+		cache.emplace_back(modulus);
+		return cache.back();
+	}
+};
+
+
+/// @brief bases[i]^exponents[i] mod modulus for every i, spread across the executor
+template <uint8_t N, uint8_t M>
+std::vector<uint_array<N>> parallelModPow(ParallelExecutor& executor, const uint_array<N>& modulus,
+										  const std::vector<uint_array<N>>& bases, const std::vector<uint_array<M>>& exponents) {
+	if (bases.size() != exponents.size()) {
+		throw std::invalid_argument("Every base needs exactly one exponent.");
+	}
+	if ((modulus.limbs()[0] & 1U) == 0) {	// Checked here so the error surfaces on the calling thread
+		throw std::invalid_argument("Montgomery modulus must be odd.");
+	}
+	std::vector<uint_array<N>> results(bases.size());
+	executor.parallelFor(bases.size(), [&](const size_t i) {
+		results[i] = ParallelExecutor::montgomeryContext(modulus).modPow(bases[i], exponents[i]);
+	});
+	return results;
+}
@@ -0,0 +1,133 @@
+// Author: Marek Oczadly
+// License: MIT
+// scratch-arena.hpp
+
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+#include <type_traits>
+#include "utils.hpp"
+
+
+/// @brief Per-thread bump allocator for big-integer temporaries with push/pop frame semantics.
+/// Memory is only reclaimed by popping a frame, so allocation is a pointer bump and freeing a whole frame is O(1).
+/// Blocks are kept after a frame is popped and reused by the next one, so steady state use never touches the heap.
+class ScratchArena {
+private:
+	static constexpr size_t BLOCK_SIZE = 64 * 1024;
+	static constexpr size_t ALIGNMENT = 64;	// Cache line - also satisfies every SIMD load used by the kernels
+
+	struct Block {
+		std::unique_ptr<std::byte[]> memory;
+		size_t size;
+	};
+
+	std::vector<Block> blocks;
+	size_t blockIdx = 0;	// Block currently being bumped
+	size_t offset = 0;		// Bytes used in blocks[blockIdx]
+	size_t used = 0;		// Bytes handed out across all blocks (including alignment padding)
+	size_t peak = 0;
+
+	static std::byte* alignUp(std::byte* ptr) noexcept {
+		const uintptr_t value = reinterpret_cast<uintptr_t>(ptr);
+		return reinterpret_cast<std::byte*>((value + ALIGNMENT - 1) & ~(uintptr_t)(ALIGNMENT - 1));
+	}
+
+	std::byte* allocateBytes(const size_t bytes) {
+		while (blockIdx < blocks.size()) {
+			Block& block = blocks[blockIdx];
+			std::byte* start = alignUp(block.memory.get() + offset);
+			const size_t end = static_cast<size_t>(start - block.memory.get()) + bytes;
+			if (end <= block.size) {
+				used += end - offset;
+				offset = end;
+				peak = std::max(peak, used);
+				return start;
+			}
+			used += block.size - offset;	// The rest of the block is wasted until the frame is popped
+			++blockIdx;
+			offset = 0;
+		}
+		const size_t size = std::max(BLOCK_SIZE, bytes + ALIGNMENT);
+		blocks.push_back(Block{ std::make_unique<std::byte[]>(size), size });
+		blockIdx = blocks.size() - 1;
+		offset = 0;
+		return allocateBytes(bytes);
+	}
+
+public:
+	/// @brief Saved arena position. Restoring it frees everything allocated since it was taken
+	struct Marker {
+		size_t blockIdx;
+		size_t offset;
+		size_t used;
+	};
+
+	/// @brief RAII frame - everything allocated while it is alive is released when it goes out of scope
+	class Frame {
+	private:
+		ScratchArena& arena;
+		const Marker marker;
+	public:
+		explicit Frame(ScratchArena& owner) noexcept : arena(owner), marker(owner.push()) {}
+		~Frame() {
+			arena.pop(marker);
+		}
+		Frame(const Frame&) = delete;
+		Frame& operator=(const Frame&) = delete;
+	};
+
+	ScratchArena() = default;
+	ScratchArena(const ScratchArena&) = delete;
+	ScratchArena& operator=(const ScratchArena&) = delete;
+
+	/// @brief The arena of the calling thread
+	static ScratchArena& local() noexcept {
+		static thread_local ScratchArena arena;
+		return arena;
+	}
+
+	Marker push() const noexcept {
+		return Marker{ blockIdx, offset, used };
+	}
+
+	void pop(const Marker& marker) noexcept {
+		blockIdx = marker.blockIdx;
+		offset = marker.offset;
+		used = marker.used;
+	}
+
+	/// @brief Uninitialised storage for count objects. Only for trivially destructible types as no destructors are run
+	template <typename T>
+	T* allocate(const size_t count) {
+		static_assert(std::is_trivially_destructible_v<T>, "Arena memory is released without running destructors.");
+		static_assert(alignof(T) <= ALIGNMENT, "Type is over-aligned for the arena.");
+		return reinterpret_cast<T*>(allocateBytes(count * sizeof(T)));
+	}
+
+	/// @brief Bytes currently allocated from the arena
+	size_t bytesInUse() const noexcept {
+		return used;
+	}
+
+	/// @brief Highest bytesInUse() since the last resetPeak()
+	size_t peakBytes() const noexcept {
+		return peak;
+	}
+
+	void resetPeak() noexcept {
+		peak = used;
+	}
+
+	/// @brief Bytes reserved from the heap by this arena
+	size_t capacity() const noexcept {
+		size_t total = 0;
+		for (const Block& block : blocks) {
+			total += block.size;
+		}
+		return total;
+	}
+};
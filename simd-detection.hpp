@@ -46,7 +46,7 @@ enum class SIMDLevels : unsigned short {
 	NEON = 1 << 11,     // 2048
 };
 
-std::string toString(CPUArchitectures arch) {
+inline std::string toString(CPUArchitectures arch) {
 	switch (arch) {
 	case CPUArchitectures::x86: return "x86";
 	case CPUArchitectures::x86_64: return "x86-64";
@@ -57,7 +57,7 @@ std::string toString(CPUArchitectures arch) {
 	}
 }
 
-std::string toString(SIMDLevels level) {
+inline std::string toString(SIMDLevels level) {
 	switch (level) {
 	case SIMDLevels::NONE: return "None";
 	case SIMDLevels::SSE2: return "SSE2";
@@ -252,5 +252,5 @@ public:
 
 #ifndef SIMD_INTEGER_SUPPORT
 #define SIMD_INTEGER_SUPPORT
-extern SIMDIntegerSupport simdSupport;	// Global instance of SIMDIntegerSupport
+inline SIMDIntegerSupport simdSupport;	// Global instance of SIMDIntegerSupport - shared by every translation unit
 #endif
\ No newline at end of file
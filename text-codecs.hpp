@@ -0,0 +1,433 @@
+// Author: Marek Oczadly
+// License: MIT
+// text-codecs.hpp
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <stdexcept>
+#include "utils.hpp"
+#include "largeInt.hpp"
+#include "simd-detection.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#	define TEXT_CODECS_X86
+#	include <immintrin.h>
+#endif
+
+// The SIMD kernels are compiled for their instruction set regardless of the build flags and picked at runtime
+// through simdSupport. MSVC allows intrinsics in any function so needs no attribute
+#if defined(__GNUC__) || defined(__clang__)
+#	define TEXT_CODECS_TARGET(isa) __attribute__((target(isa)))
+#else
+#	define TEXT_CODECS_TARGET(isa)
+#endif
+
+
+/*
+	======================= SCALAR KERNELS =======================
+	Each kernel processes as much of the input as it can and returns how much that was, so the dispatchers
+	can hand the tail to the next narrower kernel.
+*/
+
+constexpr const char HEX_DIGITS[] = "0123456789abcdef";
+constexpr const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/// @brief Hex value of a character, or -1
+constexpr int8_t hexValue(const char c) noexcept {
+	return (c >= '0' && c <= '9') ? static_cast<int8_t>(c - '0')
+		: (c >= 'a' && c <= 'f') ? static_cast<int8_t>(c - 'a' + 10)
+		: (c >= 'A' && c <= 'F') ? static_cast<int8_t>(c - 'A' + 10) : -1;
+}
+
+/// @brief Base64 value of a character, or -1
+constexpr int8_t base64Value(const char c) noexcept {
+	return (c >= 'A' && c <= 'Z') ? static_cast<int8_t>(c - 'A')
+		: (c >= 'a' && c <= 'z') ? static_cast<int8_t>(c - 'a' + 26)
+		: (c >= '0' && c <= '9') ? static_cast<int8_t>(c - '0' + 52)
+		: (c == '+') ? 62 : (c == '/') ? 63 : -1;
+}
+
+inline void hexEncodeScalar(const uint8_t* in, const size_t count, char* out) noexcept {
+	for (size_t i = 0; i < count; ++i) {
+		out[2 * i] = HEX_DIGITS[in[i] >> 4];
+		out[2 * i + 1] = HEX_DIGITS[in[i] & 0x0F];
+	}
+}
+
+/// @return false if a character is not a hex digit
+inline bool hexDecodeScalar(const char* in, const size_t count, uint8_t* out) noexcept {
+	for (size_t i = 0; i < count; ++i) {
+		const int8_t high = hexValue(in[2 * i]), low = hexValue(in[2 * i + 1]);
+		if ((high | low) < 0) {
+			return false;
+		}
+		out[i] = static_cast<uint8_t>((high << 4) | low);
+	}
+	return true;
+}
+
+/// @brief Encodes whole 3 byte groups only. count must be a multiple of 3
+inline void base64EncodeScalar(const uint8_t* in, const size_t count, char* out) noexcept {
+	for (size_t i = 0; i < count; i += 3, out += 4) {
+		const uint32_t group = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) | in[i + 2];
+		out[0] = BASE64_ALPHABET[group >> 18];
+		out[1] = BASE64_ALPHABET[(group >> 12) & 0x3F];
+		out[2] = BASE64_ALPHABET[(group >> 6) & 0x3F];
+		out[3] = BASE64_ALPHABET[group & 0x3F];
+	}
+}
+
+/// @brief Decodes whole 4 character groups without padding. count must be a multiple of 4
+/// @return false if a character is outside the alphabet
+inline bool base64DecodeScalar(const char* in, const size_t count, uint8_t* out) noexcept {
+	for (size_t i = 0; i < count; i += 4, out += 3) {
+		const int8_t a = base64Value(in[i]), b = base64Value(in[i + 1]), c = base64Value(in[i + 2]), d = base64Value(in[i + 3]);
+		if ((a | b | c | d) < 0) {
+			return false;
+		}
+		const uint32_t group = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+		out[0] = static_cast<uint8_t>(group >> 16);
+		out[1] = static_cast<uint8_t>(group >> 8);
+		out[2] = static_cast<uint8_t>(group);
+	}
+	return true;
+}
+
+
+#if defined(TEXT_CODECS_X86)
+/*
+	======================= SSSE3 / AVX2 KERNELS =======================
+	Hex: pshufb looks up the digit of each nibble. Base64 follows Mula and Lemire - pshufb spreads 3 bytes over
+	4 lanes, multiplies move each 6 bit field into its own byte and a second pshufb maps ranges to the alphabet.
+*/
+
+/// @return Bytes encoded (a multiple of 16)
+TEXT_CODECS_TARGET("ssse3")
+inline size_t hexEncodeSSSE3(const uint8_t* in, const size_t count, char* out) noexcept {
+	const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS));
+	const __m128i lowMask = _mm_set1_epi8(0x0F);
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), lowMask));
+		const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, lowMask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(high, low));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+	}
+	return i;
+}
+
+/// @return Bytes encoded (a multiple of 32)
+TEXT_CODECS_TARGET("avx2")
+inline size_t hexEncodeAVX2(const uint8_t* in, const size_t count, char* out) noexcept {
+	const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS)));
+	const __m256i lowMask = _mm256_set1_epi8(0x0F);
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+		const __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), lowMask));
+		const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, lowMask));
+		const __m256i first = _mm256_unpacklo_epi8(high, low);	// Bytes 0-7 and 16-23
+		const __m256i second = _mm256_unpackhi_epi8(high, low);	// Bytes 8-15 and 24-31
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+	}
+	return i;
+}
+
+/// @brief Nibble values of 16 hex characters. valid is all ones where the character was a hex digit
+TEXT_CODECS_TARGET("ssse3")
+inline __m128i hexNibblesSSSE3(const __m128i chars, __m128i& valid) noexcept {
+	const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+	const __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+	const __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+	const __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+	valid = _mm_or_si128(isDigit, isLetter);
+	return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+/// @return Bytes decoded (a multiple of 16). Stops early at a block containing an invalid character
+TEXT_CODECS_TARGET("ssse3")
+inline size_t hexDecodeSSSE3(const char* in, const size_t count, uint8_t* out) noexcept {
+	const __m128i weights = _mm_set1_epi16(0x0110);	// High nibble * 16 + low nibble
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m128i validA, validB;
+		const __m128i a = hexNibblesSSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i)), validA);
+		const __m128i b = hexNibblesSSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16)), validB);
+		if (_mm_movemask_epi8(_mm_and_si128(validA, validB)) != 0xFFFF) {
+			break;
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights)));
+	}
+	return i;
+}
+
+TEXT_CODECS_TARGET("avx2")
+inline __m256i hexNibblesAVX2(const __m256i chars, __m256i& valid) noexcept {
+	const __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+	const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+	const __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+	const __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+	valid = _mm256_or_si256(isDigit, isLetter);
+	return _mm256_or_si256(_mm256_and_si256(isDigit, digit), _mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+/// @return Bytes decoded (a multiple of 32). Stops early at a block containing an invalid character
+TEXT_CODECS_TARGET("avx2")
+inline size_t hexDecodeAVX2(const char* in, const size_t count, uint8_t* out) noexcept {
+	const __m256i weights = _mm256_set1_epi16(0x0110);
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		__m256i validA, validB;
+		const __m256i a = hexNibblesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), validA);
+		const __m256i b = hexNibblesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), validB);
+		if (_mm256_movemask_epi8(_mm256_and_si256(validA, validB)) != -1) {
+			break;
+		}
+		// packus works per 128 bit lane, so the middle two quarters come out swapped
+		const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+	return i;
+}
+
+/// @return Bytes encoded (a multiple of 24). Reads 4 bytes past each block so stops 32 bytes before the end
+TEXT_CODECS_TARGET("avx2")
+inline size_t base64EncodeAVX2(const uint8_t* in, const size_t count, char* out) noexcept {
+	const __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+											1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+	const __m256i shiftLut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+											  '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+											  'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+											  '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+	size_t i = 0;
+	for (; i + 32 <= count; i += 24, out += 32) {
+		const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+		const __m256i bytes = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), spread);
+
+		const __m256i fieldsAC = _mm256_mulhi_epu16(_mm256_and_si256(bytes, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+		const __m256i fieldsBD = _mm256_mullo_epi16(_mm256_and_si256(bytes, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+		const __m256i indices = _mm256_or_si256(fieldsAC, fieldsBD);
+
+		__m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+		range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi8(indices, _mm256_shuffle_epi8(shiftLut, range)));
+	}
+	return i;
+}
+
+/// @return Characters decoded (a multiple of 32). Writes 8 bytes past each 24 byte block so stops 32 bytes before the end
+/// of the output. Stops early at a block containing a character outside the alphabet
+TEXT_CODECS_TARGET("avx2")
+inline size_t base64DecodeAVX2(const char* in, const size_t count, uint8_t* out, const size_t outCapacity) noexcept {
+	const __m256i lutLow = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+											0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m256i lutHigh = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+											 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m256i lutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+											 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i gather = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+											2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	const __m256i lowMask = _mm256_set1_epi8(0x0F);
+	size_t i = 0;
+	for (; i + 32 <= count && (i / 4) * 3 + 32 <= outCapacity; i += 32, out += 24) {
+		const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+		const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi32(chars, 4), lowMask);
+		const __m256i lowClass = _mm256_shuffle_epi8(lutLow, _mm256_and_si256(chars, lowMask));
+		const __m256i highClass = _mm256_shuffle_epi8(lutHigh, highNibbles);
+		if (!_mm256_testz_si256(lowClass, highClass)) {
+			break;
+		}
+		const __m256i isSlash = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/'));
+		const __m256i values = _mm256_add_epi8(chars, _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(isSlash, highNibbles)));
+
+		const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+		const __m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+		const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(groups, gather), _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+	}
+	return i;
+}
+#endif
+
+
+/*
+	======================= DISPATCH =======================
+*/
+
+/// @brief Writes 2 * count lowercase hex characters
+inline void hexEncode(const uint8_t* in, const size_t count, char* out) noexcept {
+	size_t done = 0;
+#if defined(TEXT_CODECS_X86)
+	if (simdSupport.AVX2()) {
+		done = hexEncodeAVX2(in, count, out);
+	}
+	if (simdSupport.SSSE3()) {
+		done += hexEncodeSSSE3(in + done, count - done, out + 2 * done);
+	}
+#endif
+	hexEncodeScalar(in + done, count - done, out + 2 * done);
+}
+
+/// @brief Reads 2 * count hex characters (either case)
+/// @return false if a character is not a hex digit
+inline bool hexDecode(const char* in, const size_t count, uint8_t* out) noexcept {
+	size_t done = 0;
+#if defined(TEXT_CODECS_X86)
+	if (simdSupport.AVX2()) {
+		done = hexDecodeAVX2(in, count, out);
+	}
+	if (simdSupport.SSSE3()) {
+		done += hexDecodeSSSE3(in + 2 * done, count - done, out + done);
+	}
+#endif
+	return hexDecodeScalar(in + 2 * done, count - done, out + done);
+}
+
+constexpr size_t base64EncodedLength(const size_t bytes) noexcept {
+	return 4 * ((bytes + 2) / 3);
+}
+
+/// @brief Writes base64EncodedLength(count) characters, padded with '='
+inline void base64Encode(const uint8_t* in, const size_t count, char* out) noexcept {
+	size_t done = 0;
+#if defined(TEXT_CODECS_X86)
+	if (simdSupport.AVX2()) {
+		done = base64EncodeAVX2(in, count, out);
+	}
+#endif
+	const size_t whole = done + (count - done) / 3 * 3;
+	base64EncodeScalar(in + done, whole - done, out + done / 3 * 4);
+	out += whole / 3 * 4;
+	if (count - whole == 1) {
+		out[0] = BASE64_ALPHABET[in[whole] >> 2];
+		out[1] = BASE64_ALPHABET[(in[whole] & 0x03) << 4];
+		out[2] = out[3] = '=';
+	}
+	else if (count - whole == 2) {
+		out[0] = BASE64_ALPHABET[in[whole] >> 2];
+		out[1] = BASE64_ALPHABET[((in[whole] & 0x03) << 4) | (in[whole + 1] >> 4)];
+		out[2] = BASE64_ALPHABET[(in[whole + 1] & 0x0F) << 2];
+		out[3] = '=';
+	}
+}
+
+/// @brief Decodes padded or unpadded base64 into out, which must hold outCapacity bytes. Bytes of out past the
+/// decoded length may be overwritten. Throws std::invalid_argument on a malformed input and std::out_of_range if the bytes do not fit
+/// @return Bytes written
+inline size_t base64Decode(std::string_view text, uint8_t* out, const size_t outCapacity) {
+	size_t padding = 0;
+	while (padding < 2 && padding < text.size() && text[text.size() - 1 - padding] == '=') {
+		++padding;
+	}
+	if (padding != 0 && text.size() % 4 != 0) {
+		throw std::invalid_argument("Padded base64 input must be a multiple of 4 characters.");
+	}
+	text.remove_suffix(padding);
+	const size_t remainder = text.size() % 4;
+	if (remainder == 1) {
+		throw std::invalid_argument("Base64 input has an invalid length.");
+	}
+	const size_t bytes = text.size() / 4 * 3 + (remainder ? remainder - 1 : 0);
+	if (bytes > outCapacity) {
+		throw std::out_of_range("Decoded base64 does not fit in the output.");
+	}
+
+	size_t done = 0;	// Characters consumed
+#if defined(TEXT_CODECS_X86)
+	if (simdSupport.AVX2()) {
+		done = base64DecodeAVX2(text.data(), text.size() - remainder, out, outCapacity);
+	}
+#endif
+	const size_t whole = text.size() - remainder;
+	if (!base64DecodeScalar(text.data() + done, whole - done, out + done / 4 * 3)) {
+		throw std::invalid_argument("Input is not valid base64.");
+	}
+	if (remainder != 0) {
+		char last[4] = { 'A', 'A', 'A', 'A' };
+		std::memcpy(last, text.data() + whole, remainder);
+		uint8_t group[3];
+		if (!base64DecodeScalar(last, 4, group)) {
+			throw std::invalid_argument("Input is not valid base64.");
+		}
+		std::memcpy(out + whole / 4 * 3, group, remainder - 1);
+	}
+	return bytes;
+}
+
+
+/*
+	======================= UINT_ARRAY =======================
+	Fixed width, big-endian - the same bytes as toBytesBE, so a value always has 16 * N hex characters
+	and base64EncodedLength(8 * N) base64 characters.
+*/
+
+template <uint8_t N>
+constexpr size_t HEX_LENGTH = 16U * N;
+
+template <uint8_t N>
+constexpr size_t BASE64_LENGTH = base64EncodedLength(8U * N);
+
+/// @brief Writes HEX_LENGTH<N> characters (no terminator). Throws std::out_of_range if out is shorter
+/// @return Characters written
+template <uint8_t N>
+size_t toHex(const uint_array<N>& value, const std::span<char> out) {
+	if (out.size() < HEX_LENGTH<N>) {
+		throw std::out_of_range("Output buffer is too small for the hex string.");
+	}
+	uint8_t bytes[8U * N];
+	value.toBytesBE(bytes);
+	hexEncode(bytes, 8U * N, out.data());
+	return HEX_LENGTH<N>;
+}
+
+/// @brief Parses up to HEX_LENGTH<N> hex digits (either case, no prefix). Throws std::invalid_argument on any other
+/// character and std::out_of_range if the value has too many digits
+template <uint8_t N>
+uint_array<N> fromHex(std::string_view text) {
+	if (text.size() > HEX_LENGTH<N>) {
+		throw std::out_of_range("Hex string has more digits than the integer.");
+	}
+	uint8_t bytes[8U * N];
+	const size_t count = (text.size() + 1) / 2;
+	if (text.size() % 2 != 0) {	// Odd length - the first digit is a byte on its own
+		const int8_t digit = hexValue(text.front());
+		if (digit < 0) {
+			throw std::invalid_argument("Input is not valid hex.");
+		}
+		bytes[0] = static_cast<uint8_t>(digit);
+		text.remove_prefix(1);
+	}
+	const size_t offset = count - text.size() / 2;
+	if (!hexDecode(text.data(), text.size() / 2, bytes + offset)) {
+		throw std::invalid_argument("Input is not valid hex.");
+	}
+	return uint_array<N>::fromBytesBE(std::span<const uint8_t>(bytes, count));
+}
+
+/// @brief Writes BASE64_LENGTH<N> characters (no terminator). Throws std::out_of_range if out is shorter
+/// @return Characters written
+template <uint8_t N>
+size_t toBase64(const uint_array<N>& value, const std::span<char> out) {
+	if (out.size() < BASE64_LENGTH<N>) {
+		throw std::out_of_range("Output buffer is too small for the base64 string.");
+	}
+	uint8_t bytes[8U * N];
+	value.toBytesBE(bytes);
+	base64Encode(bytes, 8U * N, out.data());
+	return BASE64_LENGTH<N>;
+}
+
+/// @brief Parses base64 of at most 8 * N big-endian bytes. Throws std::invalid_argument on malformed input and
+/// std::out_of_range if it decodes to more bytes than the integer holds
+template <uint8_t N>
+uint_array<N> fromBase64(const std::string_view text) {
+	uint8_t bytes[8U * N];
+	const size_t count = base64Decode(text, bytes, 8U * N);
+	return uint_array<N>::fromBytesBE(std::span<const uint8_t>(bytes, count));
+}
@@ -184,14 +184,14 @@ inline uint64_t negate_uint64(const uint64_t& value) noexcept {
 #endif
 }
 
-template <typename T, uint8_t N>
+template <typename T, size_t N>
 inline void reverseArrayInPlace(std::array<T, N>& arr) noexcept {
 	loopUnroll(N / 2)
 		std::swap(arr[i], arr[N - 1 - i]);
 	endLoop
 }
 
-template <typename T, uint8_t N>
+template <typename T, size_t N>
 inline std::array<T, N> reverseArray(const std::array<T, N>& arr) noexcept {
 	std::array<T, N> result;
 	loopUnroll(N)